@@ -37,9 +37,11 @@ public class AssetInvestigator : ModuleRules
                 "Projects",
                 "InputCore",
                 "UnrealEd",
+                "EditorSubsystem",
                 "ToolMenus",
                 "CoreUObject",
                 "Engine",
+                "EngineSettings",
                 "Slate",
                 "SlateCore",
                 "ImGui",
@@ -0,0 +1,458 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetClosureTreemap.h"
+#include "AssetDependencyGraph.h"
+#include "AssetInvestigatorUtility.h"
+
+#include "Async/Async.h"
+#include "ImGuiModule.h"
+
+namespace AssetClosureTreemapPrivate
+{
+	/**
+	 * Lays Children out inside the rectangle with the squarified algorithm: rows are filled along the short side
+	 * as long as adding the next child does not make the worst aspect ratio in the row any worse.
+	 * Children must be sorted by descending size.
+	 */
+	void Squarify(TArray<FAssetTreemapLayout::FCluster>& Clusters, TArrayView<const int32> Children, FVector2D RectMin, FVector2D RectMax)
+	{
+		double TotalSize = 0.0;
+		for (const int32 Child : Children)
+		{
+			TotalSize += Clusters[Child].Size;
+		}
+
+		const double Area = (double)(RectMax.X - RectMin.X) * (RectMax.Y - RectMin.Y);
+		if (TotalSize <= 0.0 || Area <= 0.0)
+		{
+			return;
+		}
+
+		const double Scale = Area / TotalSize;
+
+		int32 Start = 0;
+		while (Start < Children.Num())
+		{
+			const double Width = RectMax.X - RectMin.X;
+			const double Height = RectMax.Y - RectMin.Y;
+			const double Side = FMath::Min(Width, Height);
+			if (Side <= 0.0)
+			{
+				break;
+			}
+
+			const double LargestArea = Clusters[Children[Start]].Size * Scale;
+
+			int32 End = Start;
+			double RowArea = 0.0;
+			double WorstRatio = TNumericLimits<double>::Max();
+
+			while (End < Children.Num())
+			{
+				const double ItemArea = Clusters[Children[End]].Size * Scale;
+				const double Thickness = (RowArea + ItemArea) / Side;
+
+				// Sorted by size, so the extremes of the row are its first and its last item
+				const double LargestLength = LargestArea / Thickness;
+				const double SmallestLength = ItemArea / Thickness;
+				const double Ratio = FMath::Max(FMath::Max(LargestLength / Thickness, Thickness / LargestLength), FMath::Max(SmallestLength / Thickness, Thickness / SmallestLength));
+
+				if (End > Start && Ratio > WorstRatio)
+				{
+					break;
+				}
+
+				WorstRatio = Ratio;
+				RowArea += ItemArea;
+				++End;
+			}
+
+			const double Thickness = RowArea / Side;
+			const bool bColumn = Width >= Height;
+
+			double Offset = 0.0;
+			for (int32 i = Start; i < End; ++i)
+			{
+				FAssetTreemapLayout::FCluster& Cluster = Clusters[Children[i]];
+				const double Length = Cluster.Size * Scale / Thickness;
+
+				if (bColumn)
+				{
+					Cluster.Min = FVector2D(RectMin.X, RectMin.Y + Offset);
+					Cluster.Max = FVector2D(RectMin.X + Thickness, RectMin.Y + Offset + Length);
+				}
+				else
+				{
+					Cluster.Min = FVector2D(RectMin.X + Offset, RectMin.Y);
+					Cluster.Max = FVector2D(RectMin.X + Offset + Length, RectMin.Y + Thickness);
+				}
+
+				Offset += Length;
+			}
+
+			if (bColumn)
+			{
+				RectMin.X += Thickness;
+			}
+			else
+			{
+				RectMin.Y += Thickness;
+			}
+
+			Start = End;
+		}
+	}
+}
+
+void FAssetClosureTreemap::Invalidate()
+{
+	CachedLayouts.Reset();
+	CachedRootOrder.Reset();
+	++Generation;
+}
+
+TSharedPtr<const FAssetTreemapLayout> FAssetClosureTreemap::RequestLayout(const FAssetDependencyGraph& Graph, const int32 RootNode, TFunctionRef<int64(int32)> GetSize)
+{
+	if (const TSharedPtr<const FAssetTreemapLayout>* CachedLayout = CachedLayouts.Find(RootNode))
+	{
+		return *CachedLayout;
+	}
+
+	// One layout at a time, a request for another root starts once the current one is in the cache
+	if (PendingLayout.IsValid())
+	{
+		if (!PendingLayout.IsReady())
+		{
+			return nullptr;
+		}
+
+		TSharedPtr<const FAssetTreemapLayout> Layout = PendingLayout.Get();
+		PendingLayout = TFuture<TSharedPtr<const FAssetTreemapLayout>>();
+
+		if (PendingGeneration == Generation)
+		{
+			if (CachedRootOrder.Num() >= MaxCachedLayouts)
+			{
+				CachedLayouts.Remove(CachedRootOrder[0]);
+				CachedRootOrder.RemoveAt(0);
+			}
+
+			CachedLayouts.Add(PendingRootNode, Layout);
+			CachedRootOrder.Add(PendingRootNode);
+
+			if (PendingRootNode == RootNode)
+			{
+				return Layout;
+			}
+		}
+	}
+
+	// Snapshot everything the worker needs, the graph may be rebuilt while it runs
+	TArray<int32> Nodes;
+	Graph.GatherHardClosure(RootNode, Nodes);
+
+	TArray<FString> PackageNames;
+	TArray<int64> Sizes;
+	PackageNames.Reserve(Nodes.Num());
+	Sizes.Reserve(Nodes.Num());
+
+	for (const int32 NodeIndex : Nodes)
+	{
+		PackageNames.Add(Graph.GetPackageName(NodeIndex).ToString());
+		Sizes.Add(GetSize(NodeIndex));
+	}
+
+	PendingRootNode = RootNode;
+	PendingGeneration = Generation;
+	PendingLayout = Async(EAsyncExecution::ThreadPool, [Nodes = MoveTemp(Nodes), PackageNames = MoveTemp(PackageNames), Sizes = MoveTemp(Sizes)]()
+		{
+			return BuildLayout(Nodes, PackageNames, Sizes);
+		});
+
+	return nullptr;
+}
+
+TSharedPtr<const FAssetTreemapLayout> FAssetClosureTreemap::BuildLayout(const TArray<int32>& Nodes, const TArray<FString>& PackageNames, const TArray<int64>& Sizes)
+{
+	TSharedRef<FAssetTreemapLayout> Layout = MakeShared<FAssetTreemapLayout>();
+	TArray<FAssetTreemapLayout::FCluster>& Clusters = Layout->Clusters;
+
+	TArray<int32> Parents;
+	TArray<TArray<int32>> Children;
+	TMap<FString, int32> FolderClusters;
+
+	Clusters.AddDefaulted_GetRef().Label = TEXT("/");
+	Parents.Add(INDEX_NONE);
+	Children.AddDefaulted();
+
+	auto AddCluster = [&Clusters, &Parents, &Children](const int32 Parent, const FString& Label) -> FAssetTreemapLayout::FCluster&
+	{
+		const int32 ClusterIndex = Clusters.Num();
+		Children[Parent].Add(ClusterIndex);
+		Parents.Add(Parent);
+		Children.AddDefaulted();
+
+		FAssetTreemapLayout::FCluster& Cluster = Clusters.AddDefaulted_GetRef();
+		Cluster.Label = Label;
+		Cluster.Depth = Clusters[Parent].Depth + 1;
+		return Cluster;
+	};
+
+	TArray<FString> PathParts;
+	for (int32 i = 0; i < Nodes.Num(); ++i)
+	{
+		PackageNames[i].ParseIntoArray(PathParts, TEXT("/"), true);
+		if (PathParts.Num() == 0)
+		{
+			continue;
+		}
+
+		int32 Parent = 0;
+		FString FolderPath;
+
+		for (int32 PartIndex = 0; PartIndex < PathParts.Num() - 1; ++PartIndex)
+		{
+			FolderPath += TEXT("/") + PathParts[PartIndex];
+
+			if (const int32* FoundCluster = FolderClusters.Find(FolderPath))
+			{
+				Parent = *FoundCluster;
+			}
+			else
+			{
+				AddCluster(Parent, PathParts[PartIndex]);
+				Parent = Clusters.Num() - 1;
+				FolderClusters.Add(FolderPath, Parent);
+			}
+		}
+
+		// Empty packages still get a sliver so they can be found
+		FAssetTreemapLayout::FCluster& Leaf = AddCluster(Parent, PathParts.Last());
+		Leaf.Node = Nodes[i];
+		Leaf.Size = FMath::Max<int64>(Sizes[i], 1);
+	}
+
+	// Parents are always created before their children, so one backwards pass accumulates folder sizes
+	for (int32 ClusterIndex = Clusters.Num() - 1; ClusterIndex > 0; --ClusterIndex)
+	{
+		Clusters[Parents[ClusterIndex]].Size += Clusters[ClusterIndex].Size;
+	}
+
+	for (FAssetTreemapLayout::FCluster& Cluster : Clusters)
+	{
+		Cluster.Hue = (GetTypeHash(Cluster.Label) % 1024) / 1024.0f;
+	}
+
+	Clusters[0].Min = FVector2D::ZeroVector;
+	Clusters[0].Max = FVector2D(FAssetTreemapLayout::LayoutWidth, 1.0f);
+
+	TArray<int32> Stack;
+	Stack.Add(0);
+
+	while (Stack.Num() > 0)
+	{
+		const int32 ClusterIndex = Stack.Pop(false);
+		TArray<int32>& ClusterChildren = Children[ClusterIndex];
+
+		ClusterChildren.Sort([&Clusters](const int32 Child1, const int32 Child2) {
+			return Clusters[Child1].Size > Clusters[Child2].Size;
+			});
+
+		Clusters[ClusterIndex].FirstChild = Layout->ChildIndices.Num();
+		Clusters[ClusterIndex].NumChildren = ClusterChildren.Num();
+		Layout->ChildIndices.Append(ClusterChildren);
+
+		// Inset children a little so folder borders stay visible
+		const FVector2D ClusterExtent = Clusters[ClusterIndex].Max - Clusters[ClusterIndex].Min;
+		const FVector2D Inset(FMath::Min(ClusterExtent.X, ClusterExtent.Y) * 0.02f);
+
+		AssetClosureTreemapPrivate::Squarify(Clusters, ClusterChildren, Clusters[ClusterIndex].Min + Inset, Clusters[ClusterIndex].Max - Inset);
+
+		// Suffix bounds of the size sorted children, so drawing can merge any tail of them in constant time
+		for (int32 i = ClusterChildren.Num() - 1; i >= 0; --i)
+		{
+			FAssetTreemapLayout::FCluster& Child = Clusters[ClusterChildren[i]];
+			Child.TailMin = Child.Min;
+			Child.TailMax = Child.Max;
+			Child.TailSize = Child.Size;
+			Child.TailCount = 1;
+
+			if (i + 1 < ClusterChildren.Num())
+			{
+				const FAssetTreemapLayout::FCluster& Next = Clusters[ClusterChildren[i + 1]];
+				Child.TailMin = Child.TailMin.ComponentMin(Next.TailMin);
+				Child.TailMax = Child.TailMax.ComponentMax(Next.TailMax);
+				Child.TailSize += Next.TailSize;
+				Child.TailCount += Next.TailCount;
+			}
+		}
+
+		for (const int32 Child : ClusterChildren)
+		{
+			if (Children[Child].Num() > 0)
+			{
+				Stack.Add(Child);
+			}
+		}
+	}
+
+	return Layout;
+}
+
+int32 FAssetClosureTreemap::Draw(const FAssetTreemapLayout& Layout, const float Height)
+{
+	int32 ClickedNode = INDEX_NONE;
+
+	const ImVec2 CanvasPos = ImGui::GetCursorScreenPos();
+	const ImVec2 CanvasSize(FMath::Max(ImGui::GetContentRegionAvail().x, 64.0f), Height);
+
+	ImGui::InvisibleButton("TreemapCanvas", CanvasSize);
+	const bool bIsHovered = ImGui::IsItemHovered();
+
+	const ImGuiIO& IO = ImGui::GetIO();
+	const FVector2D MousePos(IO.MousePos.x - CanvasPos.x, IO.MousePos.y - CanvasPos.y);
+
+	if (bIsHovered && IO.MouseWheel != 0.0f)
+	{
+		// Keep the point under the cursor where it is while zooming
+		const float NewZoom = FMath::Clamp(Zoom * FMath::Pow(1.2f, IO.MouseWheel), 1.0f, 4096.0f);
+		Pan = MousePos - (MousePos - Pan) * (NewZoom / Zoom);
+		Zoom = NewZoom;
+	}
+
+	if (bIsHovered && ImGui::IsMouseDragging(1))
+	{
+		Pan += FVector2D(IO.MouseDelta.x, IO.MouseDelta.y);
+	}
+
+	if (bIsHovered && ImGui::IsMouseDoubleClicked(0))
+	{
+		Zoom = 1.0f;
+		Pan = FVector2D::ZeroVector;
+	}
+
+	const FVector2D Scale(CanvasSize.x / FAssetTreemapLayout::LayoutWidth * Zoom, CanvasSize.y * Zoom);
+	auto ToScreen = [&CanvasPos, &Scale, this](const FVector2D& LayoutPos)
+	{
+		return ImVec2(CanvasPos.x + Pan.X + LayoutPos.X * Scale.X, CanvasPos.y + Pan.Y + LayoutPos.Y * Scale.Y);
+	};
+
+	ImDrawList* DrawList = ImGui::GetWindowDrawList();
+	DrawList->PushClipRect(CanvasPos, ImVec2(CanvasPos.x + CanvasSize.x, CanvasPos.y + CanvasSize.y), true);
+
+	const FAssetTreemapLayout::FCluster* HoveredCluster = nullptr;
+	bool bIsTailHovered = false;
+
+	auto IsMouseInside = [bIsHovered, &IO](const ImVec2& Min, const ImVec2& Max)
+	{
+		return bIsHovered && IO.MousePos.x >= Min.x && IO.MousePos.x < Max.x && IO.MousePos.y >= Min.y && IO.MousePos.y < Max.y;
+	};
+
+	const float MinLeafArea = MinLeafPixels * MinLeafPixels;
+	auto GetScreenArea = [&Scale](const FAssetTreemapLayout::FCluster& Cluster)
+	{
+		return (Cluster.Max.X - Cluster.Min.X) * Scale.X * (Cluster.Max.Y - Cluster.Min.Y) * Scale.Y;
+	};
+
+	TArray<int32, TInlineAllocator<256>> Stack;
+	Stack.Add(0);
+
+	while (Stack.Num() > 0)
+	{
+		const FAssetTreemapLayout::FCluster& Cluster = Layout.Clusters[Stack.Pop(false)];
+
+		const ImVec2 Min = ToScreen(Cluster.Min);
+		const ImVec2 Max = ToScreen(Cluster.Max);
+
+		// Off screen clusters are skipped with everything inside them
+		if (Max.x < CanvasPos.x || Max.y < CanvasPos.y || Min.x > CanvasPos.x + CanvasSize.x || Min.y > CanvasPos.y + CanvasSize.y)
+		{
+			continue;
+		}
+
+		const float Width = Max.x - Min.x;
+		const float ClusterHeight = Max.y - Min.y;
+		const bool bShowLabel = Width > 48.0f && ClusterHeight > 16.0f;
+
+		if (Cluster.NumChildren > 0 && Width >= MinClusterPixels && ClusterHeight >= MinClusterPixels)
+		{
+			DrawList->AddRect(Min, Max, IM_COL32(200, 200, 200, 160));
+			if (bShowLabel)
+			{
+				DrawList->AddText(ImVec2(Min.x + 2.0f, Min.y + 1.0f), IM_COL32(220, 220, 220, 255), TCHAR_TO_ANSI(*Cluster.Label));
+			}
+
+			// Children are sorted by size, so their screen areas only shrink: binary search for the first one too small to draw
+			int32 NumDrawnChildren = 0;
+			for (int32 High = Cluster.NumChildren; NumDrawnChildren < High;)
+			{
+				const int32 Mid = (NumDrawnChildren + High) / 2;
+				if (GetScreenArea(Layout.Clusters[Layout.ChildIndices[Cluster.FirstChild + Mid]]) >= MinLeafArea)
+				{
+					NumDrawnChildren = Mid + 1;
+				}
+				else
+				{
+					High = Mid;
+				}
+			}
+
+			// The tail goes first so the larger siblings its bounds overlap are drawn over it
+			if (NumDrawnChildren < Cluster.NumChildren)
+			{
+				const FAssetTreemapLayout::FCluster& Tail = Layout.Clusters[Layout.ChildIndices[Cluster.FirstChild + NumDrawnChildren]];
+				const ImVec2 TailMin = ToScreen(Tail.TailMin);
+				const ImVec2 TailMax = ToScreen(Tail.TailMax);
+
+				DrawList->AddRectFilled(TailMin, TailMax, IM_COL32(90, 90, 90, 255));
+
+				if (IsMouseInside(TailMin, TailMax))
+				{
+					HoveredCluster = &Tail;
+					bIsTailHovered = true;
+				}
+			}
+
+			for (int32 i = 0; i < NumDrawnChildren; ++i)
+			{
+				Stack.Add(Layout.ChildIndices[Cluster.FirstChild + i]);
+			}
+			continue;
+		}
+
+		// Packages, and folders too small to tell their contents apart, are drawn as one block
+		const float Value = Cluster.Node == INDEX_NONE ? 0.4f : 0.6f;
+
+		DrawList->AddRectFilled(Min, Max, ImColor::HSV(Cluster.Hue, 0.45f, Value));
+		DrawList->AddRect(Min, Max, IM_COL32(0, 0, 0, 120));
+
+		if (bShowLabel)
+		{
+			DrawList->AddText(ImVec2(Min.x + 2.0f, Min.y + 1.0f), IM_COL32_WHITE, TCHAR_TO_ANSI(*Cluster.Label));
+		}
+
+		if (IsMouseInside(Min, Max))
+		{
+			HoveredCluster = &Cluster;
+			bIsTailHovered = false;
+		}
+	}
+
+	DrawList->PopClipRect();
+
+	if (HoveredCluster && bIsTailHovered)
+	{
+		ImGui::SetTooltip("%d smaller items, %s", HoveredCluster->TailCount, TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(HoveredCluster->TailSize, true)));
+	}
+	else if (HoveredCluster)
+	{
+		ImGui::SetTooltip("%s, %s", TCHAR_TO_ANSI(*HoveredCluster->Label), TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(HoveredCluster->Size, true)));
+
+		if (ImGui::IsMouseClicked(0))
+		{
+			ClickedNode = HoveredCluster->Node;
+		}
+	}
+
+	return ClickedNode;
+}
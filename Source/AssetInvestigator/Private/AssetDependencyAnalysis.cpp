@@ -0,0 +1,624 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetDependencyAnalysis.h"
+#include "AssetDependencyGraph.h"
+#include "Algo/Reverse.h"
+
+namespace AssetDependencyAnalysisPrivate
+{
+	/**
+	 * Root's hard closure re-indexed densely, with forward and reverse adjacency over edge ids so the residual graph of a flow can be walked.
+	 */
+	struct FLocalFlowGraph
+	{
+		TArray<int32> Nodes;
+		TArray<int32> LocalIndices;
+
+		TArray<int32> EdgeFrom;
+		TArray<int32> EdgeTo;
+		TArray<uint8> EdgeFlow;
+
+		TArray<int32> OutOffsets;
+		TArray<int32> InOffsets;
+		TArray<int32> InEdges;
+
+		void Build(const FAssetDependencyGraph& Graph, const int32 Root)
+		{
+			Graph.GatherHardClosure(Root, Nodes);
+
+			LocalIndices.Init(INDEX_NONE, Graph.Num());
+			for (int32 LocalIndex = 0; LocalIndex < Nodes.Num(); ++LocalIndex)
+			{
+				LocalIndices[Nodes[LocalIndex]] = LocalIndex;
+			}
+
+			// Edges are added in order of their source, so EdgeFrom is sorted and doubles as the forward adjacency
+			OutOffsets.Reserve(Nodes.Num() + 1);
+			for (int32 LocalIndex = 0; LocalIndex < Nodes.Num(); ++LocalIndex)
+			{
+				OutOffsets.Add(EdgeFrom.Num());
+
+				for (const int32 Dependency : Graph.GetHardDependencies(Nodes[LocalIndex]))
+				{
+					const int32 LocalDependency = LocalIndices[Dependency];
+					if (LocalDependency != INDEX_NONE && LocalDependency != LocalIndex)
+					{
+						EdgeFrom.Add(LocalIndex);
+						EdgeTo.Add(LocalDependency);
+					}
+				}
+			}
+			OutOffsets.Add(EdgeFrom.Num());
+
+			EdgeFlow.Init(0, EdgeFrom.Num());
+
+			// Counting sort of edge ids by their destination for the reverse adjacency
+			InOffsets.Init(0, Nodes.Num() + 1);
+			for (const int32 To : EdgeTo)
+			{
+				++InOffsets[To + 1];
+			}
+			for (int32 LocalIndex = 0; LocalIndex < Nodes.Num(); ++LocalIndex)
+			{
+				InOffsets[LocalIndex + 1] += InOffsets[LocalIndex];
+			}
+
+			TArray<int32> InsertPositions(InOffsets.GetData(), Nodes.Num());
+			InEdges.SetNumUninitialized(EdgeTo.Num());
+			for (int32 EdgeIndex = 0; EdgeIndex < EdgeTo.Num(); ++EdgeIndex)
+			{
+				InEdges[InsertPositions[EdgeTo[EdgeIndex]]++] = EdgeIndex;
+			}
+		}
+
+		/**
+		 * Breadth first search over the residual graph. A forward edge is usable while it carries no flow, a backward edge while it does.
+		 * ParentEdges stores the edge used to reach each node, encoded as EdgeIndex for forward and ~EdgeIndex for backward edges.
+		 *
+		 * @return True if Sink was reached.
+		 */
+		bool FindAugmentingPath(const int32 Source, const int32 Sink, TBitArray<>& OutReached, TArray<int32>& ParentEdges, TArray<int32>& Queue) const
+		{
+			OutReached.Init(false, Nodes.Num());
+			Queue.Reset();
+
+			OutReached[Source] = true;
+			Queue.Add(Source);
+
+			for (int32 Cursor = 0; Cursor < Queue.Num(); ++Cursor)
+			{
+				const int32 Node = Queue[Cursor];
+
+				for (int32 EdgeIndex = OutOffsets[Node]; EdgeIndex < OutOffsets[Node + 1]; ++EdgeIndex)
+				{
+					const int32 Next = EdgeTo[EdgeIndex];
+					if (EdgeFlow[EdgeIndex] == 0 && !OutReached[Next])
+					{
+						OutReached[Next] = true;
+						ParentEdges[Next] = EdgeIndex;
+						Queue.Add(Next);
+					}
+				}
+
+				for (int32 InIndex = InOffsets[Node]; InIndex < InOffsets[Node + 1]; ++InIndex)
+				{
+					const int32 EdgeIndex = InEdges[InIndex];
+					const int32 Next = EdgeFrom[EdgeIndex];
+					if (EdgeFlow[EdgeIndex] != 0 && !OutReached[Next])
+					{
+						OutReached[Next] = true;
+						ParentEdges[Next] = ~EdgeIndex;
+						Queue.Add(Next);
+					}
+				}
+
+				if (OutReached[Sink])
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void Augment(const int32 Source, const int32 Sink, const TArray<int32>& ParentEdges)
+		{
+			for (int32 Node = Sink; Node != Source;)
+			{
+				const int32 ParentEdge = ParentEdges[Node];
+				if (ParentEdge >= 0)
+				{
+					EdgeFlow[ParentEdge] = 1;
+					Node = EdgeFrom[ParentEdge];
+				}
+				else
+				{
+					EdgeFlow[~ParentEdge] = 0;
+					Node = EdgeTo[~ParentEdge];
+				}
+			}
+		}
+	};
+
+	FAssetSizeInfo SubtractSizes(const FAssetSizeInfo& Full, const FAssetSizeInfo& Remaining)
+	{
+		FAssetSizeInfo Saved;
+		Saved.DiskSize = Full.DiskSize - Remaining.DiskSize;
+		Saved.MemorySize = Full.MemorySize - Remaining.MemorySize;
+		Saved.bHasKnownMemorySize = Full.bHasKnownMemorySize;
+		return Saved;
+	}
+
+	/**
+	 * Tarjan's strongly connected components algorithm over hard references, run with an explicit call stack so it is
+	 * linear in the size of the graph and safe on arbitrarily deep chains. Components are numbered dependencies first.
+	 *
+	 * @return The number of components, OutComponents receives the component of every node.
+	 */
+	int32 FindHardComponents(const FAssetDependencyGraph& Graph, TArray<int32>& OutComponents)
+	{
+		struct FFrame
+		{
+			int32 Node;
+			int32 NextDependency;
+		};
+
+		const int32 NumNodes = Graph.Num();
+
+		TArray<int32> Indices;
+		TArray<int32> LowLinks;
+		Indices.Init(INDEX_NONE, NumNodes);
+		LowLinks.SetNumUninitialized(NumNodes);
+		OutComponents.Init(INDEX_NONE, NumNodes);
+
+		TBitArray<> OnStack(false, NumNodes);
+		TArray<int32> ComponentStack;
+		TArray<FFrame> CallStack;
+		int32 NextIndex = 0;
+		int32 NumComponents = 0;
+
+		auto Discover = [&](const int32 Node)
+		{
+			Indices[Node] = LowLinks[Node] = NextIndex++;
+			ComponentStack.Add(Node);
+			OnStack[Node] = true;
+			CallStack.Add({ Node, 0 });
+		};
+
+		for (int32 StartNode = 0; StartNode < NumNodes; ++StartNode)
+		{
+			if (Indices[StartNode] != INDEX_NONE)
+			{
+				continue;
+			}
+
+			Discover(StartNode);
+
+			while (CallStack.Num() > 0)
+			{
+				const int32 Node = CallStack.Last().Node;
+				const TArrayView<const int32> Dependencies = Graph.GetHardDependencies(Node);
+
+				if (CallStack.Last().NextDependency < Dependencies.Num())
+				{
+					const int32 Dependency = Dependencies[CallStack.Last().NextDependency++];
+
+					if (Indices[Dependency] == INDEX_NONE)
+					{
+						Discover(Dependency);
+					}
+					else if (OnStack[Dependency])
+					{
+						LowLinks[Node] = FMath::Min(LowLinks[Node], Indices[Dependency]);
+					}
+					continue;
+				}
+
+				// All dependencies done, this is where the recursive version would return to its caller
+				CallStack.Pop(false);
+				if (CallStack.Num() > 0)
+				{
+					const int32 Caller = CallStack.Last().Node;
+					LowLinks[Caller] = FMath::Min(LowLinks[Caller], LowLinks[Node]);
+				}
+
+				if (LowLinks[Node] != Indices[Node])
+				{
+					continue;
+				}
+
+				const int32 ComponentIndex = NumComponents++;
+
+				int32 Member = INDEX_NONE;
+				do
+				{
+					Member = ComponentStack.Pop(false);
+					OnStack[Member] = false;
+					OutComponents[Member] = ComponentIndex;
+				} while (Member != Node);
+			}
+		}
+
+		return NumComponents;
+	}
+}
+
+bool AssetDependencyAnalysis::FindHardPath(const FAssetDependencyGraph& Graph, const int32 Root, const int32 Target, TArray<int32>& OutPath)
+{
+	OutPath.Reset();
+
+	TArray<int32> Parents;
+	Parents.Init(INDEX_NONE, Graph.Num());
+	Parents[Root] = Root;
+
+	TArray<int32> Queue;
+	Queue.Add(Root);
+
+	for (int32 Cursor = 0; Cursor < Queue.Num() && Parents[Target] == INDEX_NONE; ++Cursor)
+	{
+		for (const int32 Dependency : Graph.GetHardDependencies(Queue[Cursor]))
+		{
+			if (Parents[Dependency] == INDEX_NONE)
+			{
+				Parents[Dependency] = Queue[Cursor];
+				Queue.Add(Dependency);
+			}
+		}
+	}
+
+	if (Parents[Target] == INDEX_NONE)
+	{
+		return false;
+	}
+
+	for (int32 Node = Target; Node != Root; Node = Parents[Node])
+	{
+		OutPath.Add(Node);
+	}
+	OutPath.Add(Root);
+
+	Algo::Reverse(OutPath);
+	return true;
+}
+
+bool AssetDependencyAnalysis::ExplainHardDependency(const FAssetDependencyGraph& Graph, const int32 Root, const int32 Target, FAssetDependencyExplanation& OutExplanation)
+{
+	OutExplanation = FAssetDependencyExplanation();
+
+	if (!FindHardPath(Graph, Root, Target, OutExplanation.Path))
+	{
+		return false;
+	}
+
+	// Nothing to cut when the root itself is the heavy package
+	if (Root == Target)
+	{
+		return true;
+	}
+
+	AssetDependencyAnalysisPrivate::FLocalFlowGraph FlowGraph;
+	FlowGraph.Build(Graph, Root);
+
+	const int32 Source = FlowGraph.LocalIndices[Root];
+	const int32 Sink = FlowGraph.LocalIndices[Target];
+
+	TBitArray<> Reached;
+	TArray<int32> ParentEdges;
+	ParentEdges.Init(INDEX_NONE, FlowGraph.Nodes.Num());
+	TArray<int32> Queue;
+
+	// Every augmenting path carries one unit, so the number of rounds equals the size of the minimum cut
+	int32 FlowValue = 0;
+	while (FlowGraph.FindAugmentingPath(Source, Sink, Reached, ParentEdges, Queue))
+	{
+		if (++FlowValue > MaxCutEdges)
+		{
+			OutExplanation.bCutTooLarge = true;
+			return true;
+		}
+
+		FlowGraph.Augment(Source, Sink, ParentEdges);
+	}
+
+	// The last search stopped at the cut: saturated edges leaving the reached side form it
+	for (int32 EdgeIndex = 0; EdgeIndex < FlowGraph.EdgeFrom.Num(); ++EdgeIndex)
+	{
+		if (Reached[FlowGraph.EdgeFrom[EdgeIndex]] && !Reached[FlowGraph.EdgeTo[EdgeIndex]])
+		{
+			FAssetDependencyCut& Cut = OutExplanation.Cuts.AddDefaulted_GetRef();
+			Cut.FromNode = FlowGraph.Nodes[FlowGraph.EdgeFrom[EdgeIndex]];
+			Cut.ToNode = FlowGraph.Nodes[FlowGraph.EdgeTo[EdgeIndex]];
+		}
+	}
+
+	const FAssetSizeInfo FullSize = Graph.SumSizes(FlowGraph.Nodes);
+
+	TArray<int32> RemainingNodes;
+	for (FAssetDependencyCut& Cut : OutExplanation.Cuts)
+	{
+		GatherHardClosureWithout(Graph, Root, MakeArrayView(&Cut, 1), RemainingNodes);
+		Cut.SavedSize = AssetDependencyAnalysisPrivate::SubtractSizes(FullSize, Graph.SumSizes(RemainingNodes));
+	}
+
+	GatherHardClosureWithout(Graph, Root, OutExplanation.Cuts, RemainingNodes);
+	OutExplanation.TotalSavedSize = AssetDependencyAnalysisPrivate::SubtractSizes(FullSize, Graph.SumSizes(RemainingNodes));
+
+	// Largest savings first, that is the edge worth looking at
+	OutExplanation.Cuts.Sort([](const FAssetDependencyCut& Cut1, const FAssetDependencyCut& Cut2) {
+		return Cut1.SavedSize.MemorySize != Cut2.SavedSize.MemorySize ? Cut1.SavedSize.MemorySize > Cut2.SavedSize.MemorySize : Cut1.SavedSize.DiskSize > Cut2.SavedSize.DiskSize;
+		});
+
+	return true;
+}
+
+void AssetDependencyAnalysis::GatherHardClosureWithout(const FAssetDependencyGraph& Graph, const int32 Root, TArrayView<const FAssetDependencyCut> RemovedEdges, TArray<int32>& OutNodes)
+{
+	OutNodes.Reset();
+
+	TBitArray<> Visited(false, Graph.Num());
+	Visited[Root] = true;
+	OutNodes.Add(Root);
+
+	for (int32 Cursor = 0; Cursor < OutNodes.Num(); ++Cursor)
+	{
+		const int32 Node = OutNodes[Cursor];
+
+		for (const int32 Dependency : Graph.GetHardDependencies(Node))
+		{
+			if (Visited[Dependency])
+			{
+				continue;
+			}
+
+			const bool bIsRemoved = RemovedEdges.ContainsByPredicate([Node, Dependency](const FAssetDependencyCut& Cut) {
+				return Cut.FromNode == Node && Cut.ToNode == Dependency;
+				});
+
+			if (!bIsRemoved)
+			{
+				Visited[Dependency] = true;
+				OutNodes.Add(Dependency);
+			}
+		}
+	}
+}
+
+void AssetDependencyAnalysis::FindHardCycles(const FAssetDependencyGraph& Graph, TArray<FAssetDependencyCycle>& OutCycles)
+{
+	OutCycles.Reset();
+
+	const int32 NumNodes = Graph.Num();
+
+	TArray<int32> Components;
+	const int32 NumComponents = AssetDependencyAnalysisPrivate::FindHardComponents(Graph, Components);
+
+	// Only components with an edge inside them are cycles, which also covers single packages referencing themselves
+	TArray<int32> CycleIndices;
+	CycleIndices.Init(INDEX_NONE, NumComponents);
+
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		for (const int32 Dependency : Graph.GetHardDependencies(Node))
+		{
+			const int32 ComponentIndex = Components[Node];
+			if (ComponentIndex != Components[Dependency])
+			{
+				continue;
+			}
+
+			if (CycleIndices[ComponentIndex] == INDEX_NONE)
+			{
+				CycleIndices[ComponentIndex] = OutCycles.AddDefaulted();
+			}
+
+			OutCycles[CycleIndices[ComponentIndex]].Edges.Emplace(Node, Dependency);
+		}
+	}
+
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		const int32 CycleIndex = CycleIndices[Components[Node]];
+		if (CycleIndex != INDEX_NONE)
+		{
+			OutCycles[CycleIndex].Nodes.Add(Node);
+		}
+	}
+
+	for (FAssetDependencyCycle& Cycle : OutCycles)
+	{
+		Cycle.CombinedSize = Graph.SumSizes(Cycle.Nodes);
+	}
+}
+
+void AssetDependencyAnalysis::FindUnreachable(const FAssetDependencyGraph& Graph, TArrayView<const int32> Roots, TArray<int32>& OutUnreachable)
+{
+	OutUnreachable.Reset();
+
+	TBitArray<> Reached(false, Graph.Num());
+
+	TArray<int32> Queue;
+	Queue.Reserve(Graph.Num());
+
+	for (const int32 Root : Roots)
+	{
+		if (!Reached[Root])
+		{
+			Reached[Root] = true;
+			Queue.Add(Root);
+		}
+	}
+
+	auto Visit = [&Reached, &Queue](TArrayView<const int32> Dependencies)
+	{
+		for (const int32 Dependency : Dependencies)
+		{
+			if (!Reached[Dependency])
+			{
+				Reached[Dependency] = true;
+				Queue.Add(Dependency);
+			}
+		}
+	};
+
+	// Every node enters the queue at most once, so the whole walk is one pass over nodes and edges
+	for (int32 Cursor = 0; Cursor < Queue.Num(); ++Cursor)
+	{
+		Visit(Graph.GetHardDependencies(Queue[Cursor]));
+		Visit(Graph.GetSoftDependencies(Queue[Cursor]));
+	}
+
+	for (int32 Node = 0; Node < Graph.Num(); ++Node)
+	{
+		if (!Reached[Node])
+		{
+			OutUnreachable.Add(Node);
+		}
+	}
+
+	OutUnreachable.Sort([&Graph](const int32 Node1, const int32 Node2) {
+		return Graph.GetDiskSize(Node1) > Graph.GetDiskSize(Node2);
+		});
+}
+
+void AssetDependencyAnalysis::GatherExclusiveSizes(const FAssetDependencyGraph& Graph, TArrayView<const int32> Roots, TArray<FAssetSizeInfo>& OutExclusiveSizes)
+{
+	// Owner of every node: the first root whose closure reached it, SharedOwner once a second root does too
+	static const int32 SharedOwner = -2;
+
+	TArray<int32> Owners;
+	Owners.Init(INDEX_NONE, Graph.Num());
+
+	// The same root listed twice must not share its closure with itself
+	TMap<int32, int32> FirstRootIndices;
+	FirstRootIndices.Reserve(Roots.Num());
+
+	TArray<int32> Closure;
+	for (int32 RootIndex = 0; RootIndex < Roots.Num(); ++RootIndex)
+	{
+		if (FirstRootIndices.FindOrAdd(Roots[RootIndex], RootIndex) != RootIndex)
+		{
+			continue;
+		}
+
+		Graph.GatherHardClosure(Roots[RootIndex], Closure);
+
+		for (const int32 Node : Closure)
+		{
+			Owners[Node] = Owners[Node] == INDEX_NONE ? RootIndex : SharedOwner;
+		}
+	}
+
+	OutExclusiveSizes.Reset();
+	OutExclusiveSizes.AddDefaulted(Roots.Num());
+
+	for (int32 Node = 0; Node < Graph.Num(); ++Node)
+	{
+		if (Owners[Node] < 0)
+		{
+			continue;
+		}
+
+		FAssetSizeInfo& ExclusiveSize = OutExclusiveSizes[Owners[Node]];
+		ExclusiveSize.DiskSize += Graph.GetDiskSize(Node);
+
+		if (Graph.GetMemorySize(Node) == FAssetDependencyGraph::UnknownSize)
+		{
+			ExclusiveSize.bHasKnownMemorySize = false;
+		}
+		else
+		{
+			ExclusiveSize.MemorySize += Graph.GetMemorySize(Node);
+		}
+	}
+
+	for (int32 RootIndex = 0; RootIndex < Roots.Num(); ++RootIndex)
+	{
+		OutExclusiveSizes[RootIndex] = OutExclusiveSizes[FirstRootIndices[Roots[RootIndex]]];
+	}
+}
+
+void AssetDependencyAnalysis::FindReverseRoots(const FAssetDependencyGraph& Graph, TArrayView<const int32> Targets, TArray<TArray<int32>>& OutRoots)
+{
+	const int32 NumNodes = Graph.Num();
+
+	// Counting sort of the hard edges by destination, the same layout as the graph's forward adjacency
+	TArray<int32> ReferencerOffsets;
+	ReferencerOffsets.Init(0, NumNodes + 1);
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		for (const int32 Dependency : Graph.GetHardDependencies(Node))
+		{
+			++ReferencerOffsets[Dependency + 1];
+		}
+	}
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		ReferencerOffsets[Node + 1] += ReferencerOffsets[Node];
+	}
+
+	TArray<int32> InsertPositions(ReferencerOffsets.GetData(), NumNodes);
+	TArray<int32> Referencers;
+	Referencers.SetNumUninitialized(ReferencerOffsets[NumNodes]);
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		for (const int32 Dependency : Graph.GetHardDependencies(Node))
+		{
+			Referencers[InsertPositions[Dependency]++] = Node;
+		}
+	}
+
+	// A package is a root if its component has no referencer outside it, so every package of a cycle nothing else references is one
+	TArray<int32> Components;
+	const int32 NumComponents = AssetDependencyAnalysisPrivate::FindHardComponents(Graph, Components);
+
+	TBitArray<> IsReferencedComponent(false, NumComponents);
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		for (const int32 Dependency : Graph.GetHardDependencies(Node))
+		{
+			if (Components[Node] != Components[Dependency])
+			{
+				IsReferencedComponent[Components[Dependency]] = true;
+			}
+		}
+	}
+
+	OutRoots.Reset();
+	OutRoots.AddDefaulted(Targets.Num());
+
+	TBitArray<> Visited(false, NumNodes);
+	TArray<int32> Queue;
+
+	for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+	{
+		Queue.Reset();
+		Queue.Add(Targets[TargetIndex]);
+		Visited[Targets[TargetIndex]] = true;
+
+		for (int32 Cursor = 0; Cursor < Queue.Num(); ++Cursor)
+		{
+			const int32 Node = Queue[Cursor];
+
+			// Referencers of a root are the rest of its component, which are roots too
+			if (!IsReferencedComponent[Components[Node]])
+			{
+				OutRoots[TargetIndex].Add(Node);
+			}
+
+			for (int32 EdgeIndex = ReferencerOffsets[Node]; EdgeIndex < ReferencerOffsets[Node + 1]; ++EdgeIndex)
+			{
+				if (!Visited[Referencers[EdgeIndex]])
+				{
+					Visited[Referencers[EdgeIndex]] = true;
+					Queue.Add(Referencers[EdgeIndex]);
+				}
+			}
+		}
+
+		// Only the touched bits are cleared, so a batch costs the sum of the reverse closures and not targets times nodes
+		for (const int32 Node : Queue)
+		{
+			Visited[Node] = false;
+		}
+	}
+}
@@ -0,0 +1,181 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetDependencyGraph.h"
+#include "AssetRegistry/AssetRegistryState.h"
+
+namespace AssetDependencyGraphPrivate
+{
+	void AppendDependencies(const FAssetRegistryState& RegistryState, const FName PackageName, const TMap<FName, int32>& NodeIndices,
+		UE::AssetRegistry::EDependencyQuery DependencyQuery, TArray<FAssetIdentifier>& Scratch, TArray<int32>& OutEdges)
+	{
+		Scratch.Reset();
+		RegistryState.GetDependencies(FAssetIdentifier(PackageName), Scratch, UE::AssetRegistry::EDependencyCategory::Package, DependencyQuery);
+
+		for (const FAssetIdentifier& Dependency : Scratch)
+		{
+			if (!Dependency.IsPackage())
+			{
+				continue;
+			}
+
+			// Script packages and other packages without package data are not part of the graph
+			if (const int32* FoundIndex = NodeIndices.Find(Dependency.PackageName))
+			{
+				OutEdges.Add(*FoundIndex);
+			}
+		}
+	}
+}
+
+// Init binds it to a reference, which needs a definition before C++17 makes static constexpr members inline
+constexpr int64 FAssetDependencyGraph::UnknownSize;
+
+void FAssetDependencyGraph::Build(const FAssetRegistryState& RegistryState, const TMap<FName, int64>* PackageSizeOverrides)
+{
+	Reset();
+
+	const auto& PackageDataMap = RegistryState.GetAssetPackageDataMap();
+
+	PackageNames.Reserve(PackageDataMap.Num());
+	NodeIndices.Reserve(PackageDataMap.Num());
+	DiskSizes.Reserve(PackageDataMap.Num());
+
+	for (const auto& Pair : PackageDataMap)
+	{
+		NodeIndices.Add(Pair.Key, PackageNames.Num());
+		PackageNames.Add(Pair.Key);
+
+		const int64* OverrideSize = PackageSizeOverrides ? PackageSizeOverrides->Find(Pair.Key) : nullptr;
+		DiskSizes.Add(OverrideSize ? *OverrideSize : (Pair.Value ? Pair.Value->DiskSize : 0));
+
+		// A partial listing leaves the rest of the packages at their uncompressed registry size
+		if (!OverrideSize && PackageSizeOverrides && PackageSizeOverrides->Num() > 0)
+		{
+			NumDiskSizeFallbacks++;
+		}
+	}
+
+	if (NumDiskSizeFallbacks > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%d of %d packages are missing from the package listing and use the registry's uncompressed DiskSize, closure disk sizes mixing both are approximate"),
+			NumDiskSizeFallbacks, PackageNames.Num());
+	}
+
+	MemorySizes.Init(UnknownSize, PackageNames.Num());
+
+	HardOffsets.Reserve(PackageNames.Num() + 1);
+	SoftOffsets.Reserve(PackageNames.Num() + 1);
+
+	for (const FName& PackageName : PackageNames)
+	{
+		HardOffsets.Add(HardEdges.Num());
+		AssetDependencyGraphPrivate::AppendDependencies(RegistryState, PackageName, NodeIndices, UE::AssetRegistry::EDependencyQuery::Hard, DependencyScratch, HardEdges);
+
+		SoftOffsets.Add(SoftEdges.Num());
+		AssetDependencyGraphPrivate::AppendDependencies(RegistryState, PackageName, NodeIndices, UE::AssetRegistry::EDependencyQuery::Soft, DependencyScratch, SoftEdges);
+	}
+
+	HardOffsets.Add(HardEdges.Num());
+	SoftOffsets.Add(SoftEdges.Num());
+}
+
+void FAssetDependencyGraph::Reset()
+{
+	PackageNames.Reset();
+	NodeIndices.Reset();
+	DiskSizes.Reset();
+	MemorySizes.Reset();
+	HardOffsets.Reset();
+	HardEdges.Reset();
+	SoftOffsets.Reset();
+	SoftEdges.Reset();
+	NumDiskSizeFallbacks = 0;
+}
+
+int32 FAssetDependencyGraph::FindNode(const FName PackageName) const
+{
+	const int32* FoundIndex = NodeIndices.Find(PackageName);
+	return FoundIndex ? *FoundIndex : INDEX_NONE;
+}
+
+TArrayView<const int32> FAssetDependencyGraph::GetHardDependencies(const int32 NodeIndex) const
+{
+	return TArrayView<const int32>(HardEdges.GetData() + HardOffsets[NodeIndex], HardOffsets[NodeIndex + 1] - HardOffsets[NodeIndex]);
+}
+
+TArrayView<const int32> FAssetDependencyGraph::GetSoftDependencies(const int32 NodeIndex) const
+{
+	return TArrayView<const int32>(SoftEdges.GetData() + SoftOffsets[NodeIndex], SoftOffsets[NodeIndex + 1] - SoftOffsets[NodeIndex]);
+}
+
+void FAssetDependencyGraph::GatherHardClosure(const int32 RootNode, TArray<int32>& OutNodes) const
+{
+	OutNodes.Reset();
+
+	TBitArray<> Visited(false, Num());
+	Visited[RootNode] = true;
+	OutNodes.Add(RootNode);
+
+	// OutNodes doubles as the work queue, everything after Cursor still needs to be expanded
+	for (int32 Cursor = 0; Cursor < OutNodes.Num(); ++Cursor)
+	{
+		for (const int32 Dependency : GetHardDependencies(OutNodes[Cursor]))
+		{
+			if (!Visited[Dependency])
+			{
+				Visited[Dependency] = true;
+				OutNodes.Add(Dependency);
+			}
+		}
+	}
+}
+
+int32 FAssetDependencyGraph::GatherHardClosure(const int32 RootNode, TArrayView<int32> NodeBuffer, TArrayView<uint32> VisitedBits) const
+{
+	int32 NumNodes = 0;
+
+	VisitedBits[RootNode >> 5] |= 1u << (RootNode & 31);
+	NodeBuffer[NumNodes++] = RootNode;
+
+	for (int32 Cursor = 0; Cursor < NumNodes; ++Cursor)
+	{
+		for (const int32 Dependency : GetHardDependencies(NodeBuffer[Cursor]))
+		{
+			const uint32 Mask = 1u << (Dependency & 31);
+			if ((VisitedBits[Dependency >> 5] & Mask) == 0)
+			{
+				VisitedBits[Dependency >> 5] |= Mask;
+				NodeBuffer[NumNodes++] = Dependency;
+			}
+		}
+	}
+
+	// Only the words touched by this closure need clearing, which keeps repeated walks proportional to the closure, not the graph
+	for (int32 i = 0; i < NumNodes; ++i)
+	{
+		VisitedBits[NodeBuffer[i] >> 5] = 0;
+	}
+
+	return NumNodes;
+}
+
+FAssetSizeInfo FAssetDependencyGraph::SumSizes(TArrayView<const int32> Nodes) const
+{
+	FAssetSizeInfo AssetSizeInfo;
+
+	for (const int32 NodeIndex : Nodes)
+	{
+		AssetSizeInfo.DiskSize += DiskSizes[NodeIndex];
+
+		if (MemorySizes[NodeIndex] != UnknownSize)
+		{
+			AssetSizeInfo.MemorySize += MemorySizes[NodeIndex];
+		}
+		else
+		{
+			AssetSizeInfo.bHasKnownMemorySize = false;
+		}
+	}
+
+	return AssetSizeInfo;
+}
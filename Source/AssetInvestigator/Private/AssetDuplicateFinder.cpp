@@ -0,0 +1,351 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetDuplicateFinder.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopedSlowTask.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/PackageFileSummary.h"
+
+#include "Engine/Texture2D.h"
+#include "Engine/TextureCube.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/SkeletalMesh.h"
+#include "Sound/SoundWave.h"
+#include "Animation/AnimSequence.h"
+
+#define LOCTEXT_NAMESPACE "FAssetInvestigatorModule"
+
+void FAssetDuplicateFinder::FindDuplicates(TArray<FAssetDuplicateGroup>& OutGroups)
+{
+	OutGroups.Reset();
+
+	FScopedSlowTask SlowTask(3, LOCTEXT("FindingDuplicates", "Finding duplicate assets..."));
+	SlowTask.MakeDialogDelayed(.1f);
+
+	if (!bHasLoadedCache)
+	{
+		LoadCache();
+		bHasLoadedCache = true;
+	}
+
+	// Content classes big enough to matter, duplicated Blueprints or data assets are rare and small
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+	Filter.PackagePaths.Add("/Game");
+	Filter.ClassNames.Add(UTexture2D::StaticClass()->GetFName());
+	Filter.ClassNames.Add(UTextureCube::StaticClass()->GetFName());
+	Filter.ClassNames.Add(USoundWave::StaticClass()->GetFName());
+	Filter.ClassNames.Add(UStaticMesh::StaticClass()->GetFName());
+	Filter.ClassNames.Add(USkeletalMesh::StaticClass()->GetFName());
+	Filter.ClassNames.Add(UAnimSequence::StaticClass()->GetFName());
+
+	TArray<FAssetData> FoundAssets;
+	FAssetRegistryModule::GetRegistry().GetAssets(Filter, FoundAssets);
+
+	TArray<FCandidate> Candidates;
+	Candidates.Reserve(FoundAssets.Num());
+
+	for (const FAssetData& AssetData : FoundAssets)
+	{
+		FString Filename;
+		if (FPackageName::DoesPackageExist(AssetData.PackageName.ToString(), nullptr, &Filename))
+		{
+			FCandidate& Candidate = Candidates.AddDefaulted_GetRef();
+			Candidate.PackageName = AssetData.PackageName;
+			Candidate.ClassName = AssetData.AssetClass;
+			Candidate.Filename = MoveTemp(Filename);
+		}
+	}
+
+	SlowTask.EnterProgressFrame();
+
+	// Pass 1: payload sizes. A stat is enough for files the cache already knows
+	TArray<uint8> bIsValidCandidate;
+	bIsValidCandidate.SetNumZeroed(Candidates.Num());
+
+	ParallelForBounded(Candidates.Num(), [this, &Candidates, &bIsValidCandidate](const int32 Index)
+		{
+			FCandidate& Candidate = Candidates[Index];
+
+			const FFileStatData StatData = IFileManager::Get().GetStatData(*Candidate.Filename);
+			if (!StatData.bIsValid)
+			{
+				return;
+			}
+
+			const FCacheEntry* CachedEntry = HashCache.Find(Candidate.Filename);
+			if (CachedEntry && CachedEntry->TimeStamp == StatData.ModificationTime && CachedEntry->FileSize == StatData.FileSize)
+			{
+				Candidate.Entry = *CachedEntry;
+			}
+			else
+			{
+				Candidate.Entry.TimeStamp = StatData.ModificationTime;
+				Candidate.Entry.FileSize = StatData.FileSize;
+
+				if (!ReadPayloadRange(Candidate.Filename, Candidate.Entry))
+				{
+					return;
+				}
+			}
+
+			bIsValidCandidate[Index] = 1;
+		});
+
+	SlowTask.EnterProgressFrame();
+
+	// Pass 2: only hash what shares class and payload size with another candidate
+	NumSkippedWithoutBulkData = 0;
+
+	TMap<TPair<FName, int64>, TArray<int32>> SizeBuckets;
+	for (int32 Index = 0; Index < Candidates.Num(); Index++)
+	{
+		if (bIsValidCandidate[Index] && !Candidates[Index].Entry.bHasBulkData)
+		{
+			NumSkippedWithoutBulkData++;
+		}
+		else if (bIsValidCandidate[Index])
+		{
+			SizeBuckets.FindOrAdd(TPair<FName, int64>(Candidates[Index].ClassName, Candidates[Index].Entry.PayloadSize)).Add(Index);
+		}
+	}
+
+	TArray<int32> ToHash;
+	for (const auto& Bucket : SizeBuckets)
+	{
+		if (Bucket.Value.Num() > 1)
+		{
+			for (const int32 Index : Bucket.Value)
+			{
+				if (!Candidates[Index].Entry.bHasHash)
+				{
+					ToHash.Add(Index);
+				}
+			}
+		}
+	}
+
+	ParallelForBounded(ToHash.Num(), [&Candidates, &ToHash](const int32 Index)
+		{
+			FCandidate& Candidate = Candidates[ToHash[Index]];
+			HashPayload(Candidate.Filename, Candidate.Entry);
+		});
+
+	SlowTask.EnterProgressFrame();
+
+	TMap<TPair<FName, FSHAHash>, TArray<int32>> HashBuckets;
+	for (const auto& Bucket : SizeBuckets)
+	{
+		if (Bucket.Value.Num() > 1)
+		{
+			for (const int32 Index : Bucket.Value)
+			{
+				if (Candidates[Index].Entry.bHasHash)
+				{
+					HashBuckets.FindOrAdd(TPair<FName, FSHAHash>(Candidates[Index].ClassName, Candidates[Index].Entry.Hash)).Add(Index);
+				}
+			}
+		}
+	}
+
+	for (const auto& Bucket : HashBuckets)
+	{
+		if (Bucket.Value.Num() < 2)
+		{
+			continue;
+		}
+
+		FAssetDuplicateGroup& Group = OutGroups.AddDefaulted_GetRef();
+		Group.ClassName = Bucket.Key.Key;
+
+		for (const int32 Index : Bucket.Value)
+		{
+			Group.PackageNames.Add(Candidates[Index].PackageName);
+			Group.PackageSize = FMath::Max(Group.PackageSize, Candidates[Index].Entry.FileSize);
+		}
+
+		// Headers differ between copies and are small, only the identical payload counts as wasted
+		Group.PackageNames.Sort(FNameLexicalLess());
+		Group.PayloadSize = Candidates[Bucket.Value[0]].Entry.PayloadSize;
+		Group.WastedSize = Group.PayloadSize * (Group.PackageNames.Num() - 1);
+	}
+
+	OutGroups.Sort([](const FAssetDuplicateGroup& Group1, const FAssetDuplicateGroup& Group2) {
+		return Group1.WastedSize > Group2.WastedSize;
+		});
+
+	// Rebuilt from this scan only, so packages that were deleted or moved drop out of the cache
+	HashCache.Reset();
+	for (int32 Index = 0; Index < Candidates.Num(); Index++)
+	{
+		if (bIsValidCandidate[Index])
+		{
+			HashCache.Add(Candidates[Index].Filename, Candidates[Index].Entry);
+		}
+	}
+
+	SaveCache();
+
+	UE_LOG(LogTemp, Display, TEXT("Checked %d assets, skipped %d without bulk data, hashed %d, found %d duplicate groups"),
+		Candidates.Num(), NumSkippedWithoutBulkData, ToHash.Num(), OutGroups.Num());
+}
+
+bool FAssetDuplicateFinder::ReadPayloadRange(const FString& Filename, FCacheEntry& Entry)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename));
+	if (!Reader)
+	{
+		return false;
+	}
+
+	FPackageFileSummary Summary;
+	*Reader << Summary;
+
+	if (Reader->IsError() || Summary.Tag != PACKAGE_FILE_TAG)
+	{
+		return false;
+	}
+
+	// Bulk data sits at the end of editor packages and holds the source art, the part that is identical between copies.
+	// Everything before it is serialized against the package's own name table, so it is left out entirely
+	const bool bHasInlineBulkData = Summary.BulkDataStartOffset > 0 && Summary.BulkDataStartOffset < Entry.FileSize;
+
+	Entry.PayloadOffset = bHasInlineBulkData ? Summary.BulkDataStartOffset : Entry.FileSize;
+	Entry.PayloadSize = Entry.FileSize - Entry.PayloadOffset;
+	Entry.bHasHash = false;
+
+	const int64 SeparateBulkDataSize = IFileManager::Get().FileSize(*FPaths::ChangeExtension(Filename, TEXT("ubulk")));
+	if (SeparateBulkDataSize > 0)
+	{
+		Entry.PayloadSize += SeparateBulkDataSize;
+	}
+
+	Entry.bHasBulkData = Entry.PayloadSize > 0;
+
+	return true;
+}
+
+void FAssetDuplicateFinder::HashPayload(const FString& Filename, FCacheEntry& Entry)
+{
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(ReadChunkSize);
+
+	FSHA1 Sha;
+
+	auto HashFile = [&Buffer, &Sha](const FString& FileToHash, const int64 Offset) -> bool
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FileToHash));
+		if (!Reader)
+		{
+			return false;
+		}
+
+		Reader->Seek(Offset);
+
+		for (int64 Remaining = Reader->TotalSize() - Offset; Remaining > 0;)
+		{
+			const int64 ChunkSize = FMath::Min<int64>(Remaining, Buffer.Num());
+			Reader->Serialize(Buffer.GetData(), ChunkSize);
+			if (Reader->IsError())
+			{
+				return false;
+			}
+
+			Sha.Update(Buffer.GetData(), ChunkSize);
+			Remaining -= ChunkSize;
+		}
+
+		return true;
+	};
+
+	if (!HashFile(Filename, Entry.PayloadOffset))
+	{
+		return;
+	}
+
+	const FString BulkDataFilename = FPaths::ChangeExtension(Filename, TEXT("ubulk"));
+	if (IFileManager::Get().FileExists(*BulkDataFilename) && !HashFile(BulkDataFilename, 0))
+	{
+		return;
+	}
+
+	Sha.Final();
+	Sha.GetHash(Entry.Hash.Hash);
+	Entry.bHasHash = true;
+}
+
+void FAssetDuplicateFinder::ParallelForBounded(const int32 Num, TFunctionRef<void(int32)> Work)
+{
+	if (Num == 0)
+	{
+		return;
+	}
+
+	// Each worker pulls the next index until none are left, so at most NumWorkers files are open at once
+	const int32 NumWorkers = FMath::Min3(MaxConcurrentReads, Num, FMath::Max(1, FPlatformMisc::NumberOfCoresIncludingHyperthreads()));
+	FThreadSafeCounter NextIndex;
+
+	ParallelFor(NumWorkers, [&NextIndex, &Work, Num](int32)
+		{
+			for (int32 Index = NextIndex.Increment() - 1; Index < Num; Index = NextIndex.Increment() - 1)
+			{
+				Work(Index);
+			}
+		});
+}
+
+FString FAssetDuplicateFinder::GetCachePath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("AssetInvestigator"), TEXT("DuplicateHashCache.bin"));
+}
+
+void FAssetDuplicateFinder::LoadCache()
+{
+	HashCache.Reset();
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *GetCachePath(), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(Data);
+
+	int32 Version = 0;
+	Reader << Version;
+
+	if (Version == CacheVersion)
+	{
+		Reader << HashCache;
+	}
+
+	if (Reader.IsError())
+	{
+		HashCache.Reset();
+	}
+}
+
+void FAssetDuplicateFinder::SaveCache() const
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	int32 Version = CacheVersion;
+	Writer << Version;
+	Writer << const_cast<TMap<FString, FCacheEntry>&>(HashCache);
+
+	if (!FFileHelper::SaveArrayToFile(Data, *GetCachePath()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to save duplicate hash cache: %s"), *GetCachePath());
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -1,4 +1,86 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 
-#include "AssetInfo.h"
\ No newline at end of file
+#include "AssetInfo.h"
+#include "Misc/StringBuilder.h"
+
+void FAssetInfoTable::Reset()
+{
+	PathArena.Reset();
+	PathOffsets.Reset();
+	PackageNodes.Reset();
+	MemorySizes.Reset();
+	DiskSizes.Reset();
+	KnownMemorySizes.Reset();
+	DuplicateSizes.Reset();
+	ReferenceStarts.Reset();
+	ReferenceCounts.Reset();
+	References.Reset();
+	SortedRows.Reset();
+}
+
+void FAssetInfoTable::Empty()
+{
+	PathArena.Empty();
+	PathOffsets.Empty();
+	PackageNodes.Empty();
+	MemorySizes.Empty();
+	DiskSizes.Empty();
+	KnownMemorySizes.Empty();
+	DuplicateSizes.Empty();
+	ReferenceStarts.Empty();
+	ReferenceCounts.Empty();
+	References.Empty();
+	SortedRows.Empty();
+}
+
+int32 FAssetInfoTable::Add(const FName& AssetPath, const int32 PackageNode, const FAssetSizeInfo& AssetSizeInfo, TArrayView<const int32> HardReferences)
+{
+	// Append straight from the name table into the arena, an FString here would be one allocation per row
+	TStringBuilder<256> PathBuilder;
+	AssetPath.AppendString(PathBuilder);
+
+	PathOffsets.Add(PathArena.Num());
+	PathArena.Append(PathBuilder.GetData(), PathBuilder.Len());
+	PathArena.Add(TEXT('\0'));
+
+	PackageNodes.Add(PackageNode);
+	MemorySizes.Add(AssetSizeInfo.MemorySize);
+	DiskSizes.Add(AssetSizeInfo.DiskSize);
+	KnownMemorySizes.Add(AssetSizeInfo.bHasKnownMemorySize);
+	DuplicateSizes.Add(0);
+
+	ReferenceStarts.Add(References.Num());
+	ReferenceCounts.Add(HardReferences.Num());
+	References.Append(HardReferences.GetData(), HardReferences.Num());
+
+	return SortedRows.Add(SortedRows.Num());
+}
+
+FAssetSizeInfo FAssetInfoTable::GetSizeInfo(const int32 Row) const
+{
+	FAssetSizeInfo AssetSizeInfo;
+	AssetSizeInfo.MemorySize = MemorySizes[Row];
+	AssetSizeInfo.DiskSize = DiskSizes[Row];
+	AssetSizeInfo.bHasKnownMemorySize = KnownMemorySizes[Row];
+	return AssetSizeInfo;
+}
+
+TArrayView<const int32> FAssetInfoTable::GetHardReferences(const int32 Row) const
+{
+	return TArrayView<const int32>(References.GetData() + ReferenceStarts[Row], ReferenceCounts[Row]);
+}
+
+void FAssetInfoTable::SortByMemorySize()
+{
+	SortedRows.Sort([this](const int32 Row1, const int32 Row2) {
+		return MemorySizes[Row1] > MemorySizes[Row2];
+		});
+}
+
+void FAssetInfoTable::SortByDiskSize()
+{
+	SortedRows.Sort([this](const int32 Row1, const int32 Row2) {
+		return DiskSizes[Row1] > DiskSizes[Row2];
+		});
+}
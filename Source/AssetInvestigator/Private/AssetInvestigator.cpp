@@ -22,6 +22,7 @@
 #include "ImGuiDelegates.h"
 #include "ImGuiWidgetEd.h"
 #include "Misc/ScopedSlowTask.h"
+#include "Misc/StringBuilder.h"
 #include "Kismet2/BlueprintEditorUtils.h"
 #include "Kismet2/KismetEditorUtilities.h"
 
@@ -50,6 +51,13 @@ void FAssetInvestigatorModule::StartupModule()
 	IAssetManagerEditorModule& ManagerEditorModule = IAssetManagerEditorModule::Get();
 
 	CurrentRegistrySource = ManagerEditorModule.GetCurrentRegistrySource();
+
+	// Any change to the editor registry invalidates the graph and the sizes measured in it
+	IAssetRegistry& AssetRegistry = FAssetRegistryModule::GetRegistry();
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddLambda([this](const FAssetData&) { bIsDependencyGraphStale = true; });
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddLambda([this](const FAssetData&) { bIsDependencyGraphStale = true; });
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddLambda([this](const FAssetData&, const FString&) { bIsDependencyGraphStale = true; });
+	AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddLambda([this](const FAssetData&) { bIsDependencyGraphStale = true; });
 }
 
 void FAssetInvestigatorModule::ShutdownModule()
@@ -57,6 +65,17 @@ void FAssetInvestigatorModule::ShutdownModule()
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
 
+	LiveMemoryTracker.Stop();
+
+	if (FModuleManager::Get().IsModuleLoaded("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = FAssetRegistryModule::GetRegistry();
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+		AssetRegistry.OnAssetUpdated().Remove(AssetUpdatedHandle);
+	}
+
 	UToolMenus::UnRegisterStartupCallback(this);
 
 	UToolMenus::UnregisterOwner(this);
@@ -109,63 +128,145 @@ void FAssetInvestigatorModule::UnregisterImGuiTab()
 
 void FAssetInvestigatorModule::CollectAssets()
 {
-	CachedAssets.Empty();
-	FARFilter Filter;
-	Filter.bRecursivePaths = true;
-	Filter.ClassNames.Add(UBlueprint::StaticClass()->GetFName());
-	Filter.PackagePaths.Add("/Game");
+	CachedAssets.Reset();
+
+	// Rows of the previous collect are gone, a kept selection or comparison would point at whatever row took its index
+	node_clicked = -1;
+	FoundNodes.Reset();
+	LiveMemoryTracker.ResetComparison();
 
 	progress = 0.f;
 	animateProgressBar = true;
 
-	TArray<FAssetData> FoundAssets;
-	FAssetRegistryModule::GetRegistry().GetAssets(Filter, FoundAssets);
+	// An unchanged registry keeps its graph and measured sizes, so only the roots are walked again
+	if (IsDependencyGraphStale())
+	{
+		BuildDependencyGraph();
+	}
+
+	// Every array below keeps its capacity between collects, so only a graph that grew allocates again
+	FoundAssets.Reset();
+	RootAssets.Reset();
+
+	if (bCachedAssetsAreCooked)
+	{
+		CookedRegistry.GatherRootAssets(RootAssets);
+	}
+	else
+	{
+		FARFilter Filter;
+		Filter.bRecursivePaths = true;
+		Filter.ClassNames.Add(UBlueprint::StaticClass()->GetFName());
+		Filter.PackagePaths.Add("/Game");
+
+		FAssetRegistryModule::GetRegistry().GetAssets(Filter, FoundAssets);
+
+		for (const FAssetData& Asset : FoundAssets)
+		{
+			RootAssets.Add(&Asset);
+		}
+	}
+
+	const int32 NumNodes = DependencyGraph.Num();
+	ClosureBuffer.SetNumUninitialized(NumNodes, false);
+	VisitedBits.SetNumZeroed((NumNodes + 31) / 32, false);
 
-	singleStep = 1.f / FoundAssets.Num();
+	singleStep = 1.f / FMath::Max(RootAssets.Num(), 1);
 	animateProgressBar = true;
-	for (const FAssetData& Asset : FoundAssets)
+	for (const FAssetData* Asset : RootAssets)
 	{
-		GatherAssetInformation(Asset);
+		GatherAssetInformation(*Asset, ClosureBuffer, VisitedBits);
 
 		progress += singleStep;
 	}
 
-	CachedAssets.Sort([](const FAssetInfo& Info1, const FAssetInfo& Info2) {
-		return  Info1.AssetSizeInfo.MemorySize > Info2.AssetSizeInfo.MemorySize;
-		});
+	// Cooked registries have no memory sizes, so rank them by what ships on disk
+	if (bCachedAssetsAreCooked)
+	{
+		CachedAssets.SortByDiskSize();
+	}
+	else
+	{
+		CachedAssets.SortByMemorySize();
+	}
+
+	if (DuplicateGroups.Num() > 0)
+	{
+		UpdateDuplicateSizes();
+	}
 
 	animateProgressBar = false;
 }
 
+void FAssetInvestigatorModule::BuildDependencyGraph()
+{
+	bCachedAssetsAreCooked = bUseCookedRegistry && CookedRegistry.IsLoaded();
+
+	if (bCachedAssetsAreCooked)
+	{
+		DependencyGraph.Build(CookedRegistry.GetState(), &CookedRegistry.GetPackageSizes());
+	}
+	else
+	{
+		DependencyGraph.Build(*CurrentRegistrySource->RegistryState);
+	}
+
+	bIsDependencyGraphStale = false;
+
+	// Everything below holds node indices of the previous graph
+	ExplainedRootNode = INDEX_NONE;
+	LiveMemoryTracker.ResetComparison();
+	ClosureTreemap.Invalidate();
+	HardCycles.Reset();
+	CastToCycleIndex = INDEX_NONE;
+	UnreferencedPackages.Reset();
+	UnreferencedDiskSize = 0;
+}
+
+bool FAssetInvestigatorModule::IsDependencyGraphStale() const
+{
+	return bIsDependencyGraphStale || DependencyGraph.Num() == 0 || bCachedAssetsAreCooked != (bUseCookedRegistry && CookedRegistry.IsLoaded());
+}
+
 void FAssetInvestigatorModule::ClearAssets()
 {
+	// Assets can change in memory without the registry noticing, Clear is the way to measure everything again
+	bIsDependencyGraphStale = true;
+
 	CachedAssets.Empty();
 	node_clicked = -1;
+	ExplainedRootNode = INDEX_NONE;
+	LiveMemoryTracker.ResetComparison();
+	ClosureTreemap.Invalidate();
+	HardCycles.Reset();
+	CastToCycleIndex = INDEX_NONE;
+	UnreferencedPackages.Reset();
+	UnreferencedDiskSize = 0;
 }
 
 void FAssetInvestigatorModule::CreateUtilityButtons()
 {
 	if (ImGui::SmallButton("OpenSizeMapUI"))
 	{
-		IAssetManagerEditorModule::Get().OpenSizeMapUI({ FAssetIdentifier(CachedAssets[node_clicked].PackagePath) });
+		IAssetManagerEditorModule::Get().OpenSizeMapUI({ FAssetIdentifier(DependencyGraph.GetPackageName(CachedAssets.GetPackageNode(node_clicked))) });
 	}
 	ImGui::SameLine();
 
 	if (ImGui::SmallButton("OpenReferenceViewer"))
 	{
-		IAssetManagerEditorModule::Get().OpenReferenceViewerUI({ FAssetIdentifier(CachedAssets[node_clicked].PackagePath) });
+		IAssetManagerEditorModule::Get().OpenReferenceViewerUI({ FAssetIdentifier(DependencyGraph.GetPackageName(CachedAssets.GetPackageNode(node_clicked))) });
 	}
 	ImGui::SameLine();
 
 	if (ImGui::SmallButton("OpenAsset"))
 	{
-		AssetInvestigatorUtility::OpenSelectedAsset(CachedAssets[node_clicked].AssetPath);
+		AssetInvestigatorUtility::OpenSelectedAsset(FName(CachedAssets.GetAssetPath(node_clicked)));
 	}
 	ImGui::SameLine();
 
 	if (ImGui::SmallButton("BrowseAsset"))
 	{
-		AssetInvestigatorUtility::BrowseToAsset(CachedAssets[node_clicked].AssetPath);
+		AssetInvestigatorUtility::BrowseToAsset(FName(CachedAssets.GetAssetPath(node_clicked)));
 	}
 }
 
@@ -198,22 +299,31 @@ void FAssetInvestigatorModule::InitializeUI(bool* p_open)
 	ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
 	ImGui::Text("Progress ");
 
+	CreateCookedRegistryControls();
+
 	if (ImGui::Button("ExportCurrentListToText"))
 	{
-		AssetInvestigatorUtility::ExportListToTxt(CachedAssets);
+		AssetInvestigatorUtility::ExportListToTxt(CachedAssets, FString(), &DuplicateGroups);
 	}
 	ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
 	ImGui::Text("The text file will be exported to ProjectDir() ");
 
+	DisplayLiveMemory();
+	DisplayHardCycles();
+	DisplayDuplicateAssets();
+	DisplayUnreferencedPackages();
+
 	static ImGuiWindowFlags WindowFlags = ImGuiWindowFlags_HorizontalScrollbar | ImGuiWindowFlags_NoMove;
 	ImGui::BeginChild("Details", ImVec2(ImGui::GetWindowContentRegionWidth() * 0.5f, ImGui::GetWindowHeight()), false, WindowFlags);
 	static ImGuiTreeNodeFlags base_flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_SpanAvailWidth;
 
 	for (int i = 0; i < CachedAssets.Num(); i++)
 	{
+		const int32 Row = CachedAssets.GetSortedRow(i);
+
 		// Disable the default open on single-click behavior and pass in Selected flag according to our selection state.
 		ImGuiTreeNodeFlags node_flags = base_flags;
-		const bool is_selected = i == node_clicked;
+		const bool is_selected = Row == node_clicked;
 		if (is_selected)
 		{
 			node_flags |= ImGuiTreeNodeFlags_Selected;
@@ -221,11 +331,22 @@ void FAssetInvestigatorModule::InitializeUI(bool* p_open)
 
 		node_flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
 
-		ImGui::TreeNodeEx((void*)(intptr_t)i, node_flags, "%s, %s", TCHAR_TO_ANSI(*CachedAssets[i].AssetPath.ToString()), TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(CachedAssets[i].AssetSizeInfo.MemorySize, true)));
+		const FAssetSizeInfo AssetSizeInfo = CachedAssets.GetSizeInfo(Row);
+		const FString SizeString = bCachedAssetsAreCooked ? AssetInvestigatorUtility::MakeBestSizeString(AssetSizeInfo.DiskSize, true) : AssetInvestigatorUtility::MakeBestSizeString(AssetSizeInfo.MemorySize, AssetSizeInfo.bHasKnownMemorySize);
+
+		if (CachedAssets.GetDuplicateSize(Row) > 0)
+		{
+			ImGui::TreeNodeEx((void*)(intptr_t)Row, node_flags, "%s, %s, duplicates %s", TCHAR_TO_ANSI(CachedAssets.GetAssetPath(Row)), TCHAR_TO_ANSI(*SizeString),
+				TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(CachedAssets.GetDuplicateSize(Row), true)));
+		}
+		else
+		{
+			ImGui::TreeNodeEx((void*)(intptr_t)Row, node_flags, "%s, %s", TCHAR_TO_ANSI(CachedAssets.GetAssetPath(Row)), TCHAR_TO_ANSI(*SizeString));
+		}
 
 		if (ImGui::IsItemClicked())
 		{
-			node_clicked = i;
+			node_clicked = Row;
 			FoundNodes.Empty();
 		}
 	}
@@ -238,9 +359,16 @@ void FAssetInvestigatorModule::InitializeUI(bool* p_open)
 
 	if (node_clicked != -1)
 	{
-		ImGui::Text("Selected Asset %s", TCHAR_TO_ANSI(*CachedAssets[node_clicked].AssetPath.ToString()));
-		ImGui::Text("DiskSize %s", TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(CachedAssets[node_clicked].AssetSizeInfo.DiskSize, true)));
-		ImGui::Text("MemorySize %s", TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(CachedAssets[node_clicked].AssetSizeInfo.MemorySize, true)));
+		const FAssetSizeInfo AssetSizeInfo = CachedAssets.GetSizeInfo(node_clicked);
+
+		ImGui::Text("Selected Asset %s", TCHAR_TO_ANSI(CachedAssets.GetAssetPath(node_clicked)));
+		ImGui::Text("DiskSize %s", TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(AssetSizeInfo.DiskSize, true)));
+		ImGui::Text("MemorySize %s", TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(AssetSizeInfo.MemorySize, AssetSizeInfo.bHasKnownMemorySize)));
+
+		if (DuplicateGroups.Num() > 0)
+		{
+			ImGui::Text("DuplicateSize %s", TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(CachedAssets.GetDuplicateSize(node_clicked), true)));
+		}
 
 		CreateUtilityButtons();
 		DisplayReferences(2, "Hard References", UE::AssetRegistry::EDependencyQuery::Hard);
@@ -248,11 +376,14 @@ void FAssetInvestigatorModule::InitializeUI(bool* p_open)
 
 		if (ImGui::SmallButton("Bring <CastTo> Nodes"))
 		{
-			FoundNodes = AssetInvestigatorUtility::GetDynamicCastToNodes(CachedAssets[node_clicked].AssetPath);
+			FoundNodes = AssetInvestigatorUtility::GetDynamicCastToNodes(FName(CachedAssets.GetAssetPath(node_clicked)));
 		}
 
 		ImGui::NewLine();
-		DisplayCastToNodes();
+		DisplayCastToNodes(FoundNodes);
+
+		DisplayDependencyExplanation();
+		DisplayClosureTreemap();
 	}
 
 	ImGui::EndChild();
@@ -260,93 +391,80 @@ void FAssetInvestigatorModule::InitializeUI(bool* p_open)
 	ImGui::End();
 }
 
-void FAssetInvestigatorModule::GatherSizeRecursively(const FAssetData& AssetData, FAssetSizeInfo& AssetSizeInfo, TArray<FName>& VisitedAssets)
+void FAssetInvestigatorModule::GatherAssetInformation(const FAssetData& AssetData, TArrayView<int32> ClosureBuffer, TArrayView<uint32> VisitedBits)
 {
-	TArray<FName> HardReferences;
-
-	IAssetRegistry::Get()->GetDependencies(AssetData.PackageName, HardReferences, UE::AssetRegistry::EDependencyCategory::All, UE::AssetRegistry::EDependencyQuery::Hard);
+	const int32 RootNode = DependencyGraph.FindNode(AssetData.PackageName);
+	if (RootNode == INDEX_NONE)
+	{
+		return;
+	}
 
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::Get().LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
+	const TArrayView<const int32> Closure(ClosureBuffer.GetData(), DependencyGraph.GatherHardClosure(RootNode, ClosureBuffer, VisitedBits));
 
-	//add self size
+	// Each package is measured once per graph, roots and later collects sharing dependencies reuse the cached size
+	if (!bCachedAssetsAreCooked)
 	{
-		if (!VisitedAssets.Contains(AssetData.PackageName))
+		for (const int32 NodeIndex : Closure)
 		{
-			UObject* Asset = AssetData.GetAsset();
-
-			if (Asset)
+			if (DependencyGraph.GetMemorySize(NodeIndex) == FAssetDependencyGraph::UnknownSize)
 			{
-				AssetSizeInfo.MemorySize += Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+				DependencyGraph.SetMemorySize(NodeIndex, AssetInvestigatorUtility::GetPackageMemorySize(DependencyGraph.GetPackageName(NodeIndex), PackageAssets));
 			}
-
-			if (!VisitedAssets.Contains(AssetData.PackageName))
-			{
-				const FAssetPackageData* FoundData = CurrentRegistrySource->RegistryState->GetAssetPackageData(AssetData.PackageName);
-				if (FoundData)
-				{
-					AssetSizeInfo.DiskSize += FoundData->DiskSize;
-				}
-			}
-
-			VisitedAssets.Add(AssetData.PackageName);
 		}
 	}
 
-	for (const FName& AssetName : HardReferences)
-	{
-		const FAssetData& AssetData = AssetRegistryModule.Get().GetAssetByObjectPath(AssetName);
-		if (AssetRegistryModule.Get().GetAssetByObjectPath(AssetName).IsValid())
-		{
-
-			if (VisitedAssets.Contains(AssetData.PackageName)) {
-				continue;
-			}
+	CachedAssets.Add(AssetData.ObjectPath, RootNode, DependencyGraph.SumSizes(Closure), DependencyGraph.GetHardDependencies(RootNode));
+}
 
-			// Resource size can currently only be calculated for loaded assets, so load and check
-			UObject* Asset = AssetData.GetAsset();
+void FAssetInvestigatorModule::CreateCookedRegistryControls()
+{
+	ImGui::Checkbox("UseCookedRegistry", &bUseCookedRegistry);
 
-			if (Asset)
-			{
-				AssetSizeInfo.MemorySize += Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
-			}
+	if (!bUseCookedRegistry)
+	{
+		return;
+	}
 
-			const FAssetPackageData* FoundData = CurrentRegistrySource->RegistryState->GetAssetPackageData(AssetData.PackageName);
-			if (FoundData)
-			{
-				AssetSizeInfo.DiskSize += FoundData->DiskSize;
-			}
+	ImGui::InputText("Platform", CookedPlatformName, IM_ARRAYSIZE(CookedPlatformName));
+	ImGui::InputText("PakListing (optional)", PackageListingPath, IM_ARRAYSIZE(PackageListingPath));
 
-			VisitedAssets.Add(AssetData.PackageName);
+	if (ImGui::Button("LoadCookedRegistry"))
+	{
+		bIsDependencyGraphStale = true;
 
-			GatherSizeRecursively(AssetData, AssetSizeInfo, VisitedAssets);
+		if (CookedRegistry.LoadDevelopmentRegistry(FCookedAssetRegistry::GetDevelopmentRegistryPath(ANSI_TO_TCHAR(CookedPlatformName))) && PackageListingPath[0] != '\0')
+		{
+			CookedRegistry.LoadPackageListing(ANSI_TO_TCHAR(PackageListingPath));
 		}
 	}
-}
-
-void FAssetInvestigatorModule::GatherAssetInformation(const FAssetData& AssetData)
-{
-	FAssetInfo AssetInfo;
-	AssetInfo.AssetPath = AssetData.ObjectPath;
-	AssetInfo.PackagePath = AssetData.PackageName;
-
-	TArray<FName> VisitedAssets;
+	ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
 
-	GatherSizeRecursively(AssetData, AssetInfo.AssetSizeInfo, VisitedAssets);
+	if (CookedRegistry.IsLoaded())
+	{
+		ImGui::Text("Cooked registry loaded, CollectAssets will use cooked sizes");
+	}
+	else
+	{
+		ImGui::Text("No cooked registry loaded, CollectAssets will use the editor registry");
+	}
 
-	CachedAssets.Add(AssetInfo);
+	if (bCachedAssetsAreCooked && DependencyGraph.GetNumDiskSizeFallbacks() > 0)
+	{
+		ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.2f, 1.0f), "%d packages are missing from the listing and use uncompressed sizes, disk sizes are approximate",
+			DependencyGraph.GetNumDiskSizeFallbacks());
+	}
 }
 
 void FAssetInvestigatorModule::DisplayReferences(intptr_t nodeId, const FString& categoryName, UE::AssetRegistry::EDependencyQuery dependencyQuery)
 {
 	if (ImGui::TreeNode((void*)nodeId, TCHAR_TO_ANSI(*categoryName)))
 	{
-		TArray<FName> References;
-		IAssetRegistry::Get()->GetDependencies(CachedAssets[node_clicked].PackagePath, References, UE::AssetRegistry::EDependencyCategory::All, dependencyQuery);
+		const TArrayView<const int32> References = dependencyQuery == UE::AssetRegistry::EDependencyQuery::Hard ? CachedAssets.GetHardReferences(node_clicked) : DependencyGraph.GetSoftDependencies(CachedAssets.GetPackageNode(node_clicked));
 
 		for (int n = 0; n < References.Num(); n++)
 		{
 			char label[256];
-			sprintf(label, "%s", TCHAR_TO_ANSI(*References[n].ToString()));
+			sprintf(label, "%s", TCHAR_TO_ANSI(*DependencyGraph.GetPackageName(References[n]).ToString()));
 			if (ImGui::Selectable(label)) {}
 			ImGui::NextColumn();
 		}
@@ -355,11 +473,11 @@ void FAssetInvestigatorModule::DisplayReferences(intptr_t nodeId, const FString&
 	}
 }
 
-void FAssetInvestigatorModule::DisplayCastToNodes()
+void FAssetInvestigatorModule::DisplayCastToNodes(const TArray<UEdGraphNode*>& CastToNodes)
 {
-	if (FoundNodes.Num() > 0)
+	if (CastToNodes.Num() > 0)
 	{
-		for (UEdGraphNode* Node : FoundNodes)
+		for (UEdGraphNode* Node : CastToNodes)
 		{
 			char label[256];
 			sprintf(label, "%s", TCHAR_TO_ANSI(*Node->GetNodeTitle(ENodeTitleType::EditableTitle).ToString()));
@@ -386,6 +504,469 @@ void FAssetInvestigatorModule::DisplayCastToNodes()
 	}
 }
 
+void FAssetInvestigatorModule::UpdateExplainedRoot(const int32 RootNode)
+{
+	if (RootNode == ExplainedRootNode)
+	{
+		return;
+	}
+
+	ExplainedRootNode = RootNode;
+	ExplainedTargetNode = INDEX_NONE;
+
+	DependencyGraph.GatherHardClosure(RootNode, HeavyDependencies);
+	HeavyDependencies.RemoveAt(0);
+
+	HeavyDependencies.Sort([this](const int32 Node1, const int32 Node2) {
+		return GetRankingSize(Node1) > GetRankingSize(Node2);
+		});
+}
+
+void FAssetInvestigatorModule::DisplayClosureTreemap()
+{
+	if (!ImGui::TreeNode((void*)(intptr_t)5, "Closure Treemap"))
+	{
+		return;
+	}
+
+	const int32 RootNode = CachedAssets.GetPackageNode(node_clicked);
+	const TSharedPtr<const FAssetTreemapLayout> Layout = ClosureTreemap.RequestLayout(DependencyGraph, RootNode, [this](const int32 NodeIndex) { return GetRankingSize(NodeIndex); });
+
+	if (Layout)
+	{
+		ImGui::Text("Wheel to zoom, right drag to pan, double click to reset, click a package to explain it");
+
+		// Picking a package explains why it is loaded, the same as picking it from the heavy dependency list
+		const int32 ClickedNode = ClosureTreemap.Draw(*Layout, 400.0f);
+		if (ClickedNode != INDEX_NONE && ClickedNode != RootNode)
+		{
+			UpdateExplainedRoot(RootNode);
+			ExplainedTargetNode = ClickedNode;
+			AssetDependencyAnalysis::ExplainHardDependency(DependencyGraph, RootNode, ClickedNode, Explanation);
+		}
+	}
+	else
+	{
+		ImGui::Text("Laying out closure...");
+	}
+
+	ImGui::TreePop();
+}
+
+void FAssetInvestigatorModule::DisplayDependencyExplanation()
+{
+	// Enough to find the culprits, the full closure is one click away in the size map
+	static const int32 MaxHeavyDependencies = 100;
+
+	if (!ImGui::TreeNode((void*)(intptr_t)4, "Why Is This Loaded"))
+	{
+		return;
+	}
+
+	const int32 RootNode = CachedAssets.GetPackageNode(node_clicked);
+	UpdateExplainedRoot(RootNode);
+
+	ImGui::BeginChild("HeavyDependencies", ImVec2(0, 150), true);
+
+	for (int32 i = 0; i < HeavyDependencies.Num() && i < MaxHeavyDependencies; i++)
+	{
+		const int32 NodeIndex = HeavyDependencies[i];
+
+		char label[512];
+		sprintf(label, "%s, %s", TCHAR_TO_ANSI(*DependencyGraph.GetPackageName(NodeIndex).ToString()), TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(GetRankingSize(NodeIndex), true)));
+
+		if (ImGui::Selectable(label, NodeIndex == ExplainedTargetNode))
+		{
+			ExplainedTargetNode = NodeIndex;
+			AssetDependencyAnalysis::ExplainHardDependency(DependencyGraph, RootNode, NodeIndex, Explanation);
+		}
+	}
+
+	ImGui::EndChild();
+
+	if (ExplainedTargetNode != INDEX_NONE)
+	{
+		ImGui::Text("Shortest hard reference chain");
+		for (const int32 NodeIndex : Explanation.Path)
+		{
+			ImGui::BulletText("%s", TCHAR_TO_ANSI(*DependencyGraph.GetPackageName(NodeIndex).ToString()));
+		}
+
+		if (Explanation.bCutTooLarge)
+		{
+			ImGui::Text("More than %d independent chains lead here, no small cut exists", AssetDependencyAnalysis::MaxCutEdges);
+		}
+		else
+		{
+			ImGui::Text("Removing these %d references drops it, saving %s memory, %s disk", Explanation.Cuts.Num(),
+				TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(Explanation.TotalSavedSize.MemorySize, Explanation.TotalSavedSize.bHasKnownMemorySize)),
+				TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(Explanation.TotalSavedSize.DiskSize, true)));
+
+			for (const FAssetDependencyCut& Cut : Explanation.Cuts)
+			{
+				ImGui::BulletText("%s -> %s alone saves %s", TCHAR_TO_ANSI(*DependencyGraph.GetPackageName(Cut.FromNode).ToString()), TCHAR_TO_ANSI(*DependencyGraph.GetPackageName(Cut.ToNode).ToString()),
+					TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(bCachedAssetsAreCooked ? Cut.SavedSize.DiskSize : Cut.SavedSize.MemorySize, true)));
+			}
+		}
+	}
+
+	ImGui::TreePop();
+}
+
+void FAssetInvestigatorModule::DisplayLiveMemory()
+{
+	static const int32 MaxUnclaimedPackages = 100;
+
+	if (ImGui::Checkbox("TrackLiveMemory", &bTrackLiveMemory))
+	{
+		if (bTrackLiveMemory)
+		{
+			LiveMemoryTracker.Start();
+		}
+		else
+		{
+			LiveMemoryTracker.Stop();
+		}
+	}
+
+	if (!bTrackLiveMemory)
+	{
+		return;
+	}
+
+	ImGui::SameLine();
+	ImGui::ProgressBar(LiveMemoryTracker.GetSweepProgress(), ImVec2(0.0f, 0.0f));
+	ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
+	ImGui::Text("Sweep %d", LiveMemoryTracker.GetCompletedSweeps());
+
+	if (!ImGui::CollapsingHeader("Live Memory"))
+	{
+		return;
+	}
+
+	// Comparing walks every loaded root's closure, so it only runs while shown, once per published sweep, spread over the tracker's ticks
+	if (CachedAssets.Num() > 0 && !LiveMemoryTracker.IsComparing() && LiveMemoryTracker.GetComparedSweep() != LiveMemoryTracker.GetCompletedSweeps())
+	{
+		LiveMemoryTracker.StartComparison(DependencyGraph, CachedAssets);
+	}
+
+	const FLiveMemoryComparison& LiveMemoryComparison = LiveMemoryTracker.GetComparison();
+
+	ImGui::Text("Loaded roots (resident / predicted)");
+	for (const FLiveMemoryComparison::FLoadedRoot& LoadedRoot : LiveMemoryComparison.LoadedRoots)
+	{
+		ImGui::BulletText("%s, %s / %s", TCHAR_TO_ANSI(CachedAssets.GetAssetPath(LoadedRoot.Row)),
+			TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(LoadedRoot.ResidentMemorySize, true)),
+			TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(LoadedRoot.PredictedMemorySize, true)));
+	}
+
+	ImGui::Text("Resident without a loaded root that needs them: %s", TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(LiveMemoryComparison.UnclaimedMemorySize, true)));
+	for (int32 i = 0; i < LiveMemoryComparison.UnclaimedPackages.Num() && i < MaxUnclaimedPackages; i++)
+	{
+		const FLiveMemoryComparison::FUnclaimedPackage& UnclaimedPackage = LiveMemoryComparison.UnclaimedPackages[i];
+
+		ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s, %s", TCHAR_TO_ANSI(*DependencyGraph.GetPackageName(UnclaimedPackage.Node).ToString()),
+			TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(UnclaimedPackage.ResidentMemorySize, true)));
+	}
+}
+
+void FAssetInvestigatorModule::FindHardCycles()
+{
+	// Cycles can be searched before anything was collected
+	if (DependencyGraph.Num() == 0)
+	{
+		BuildDependencyGraph();
+	}
+
+	AssetDependencyAnalysis::FindHardCycles(DependencyGraph, HardCycles);
+	CastToCycleIndex = INDEX_NONE;
+
+	SortHardCycles();
+}
+
+void FAssetInvestigatorModule::SortHardCycles()
+{
+	// Cycles found before a collect only sum the few packages measured so far, ranking those lower bounds would be meaningless
+	bHasUnknownCycleMemory = HardCycles.ContainsByPredicate([](const FAssetDependencyCycle& Cycle) {
+		return !Cycle.CombinedSize.bHasKnownMemorySize;
+		});
+
+	switch (CycleSortMode == 0 && bHasUnknownCycleMemory ? 1 : CycleSortMode)
+	{
+	case 0:
+		HardCycles.Sort([](const FAssetDependencyCycle& Cycle1, const FAssetDependencyCycle& Cycle2) {
+			return Cycle1.CombinedSize.MemorySize > Cycle2.CombinedSize.MemorySize;
+			});
+		break;
+	case 1:
+		HardCycles.Sort([](const FAssetDependencyCycle& Cycle1, const FAssetDependencyCycle& Cycle2) {
+			return Cycle1.CombinedSize.DiskSize > Cycle2.CombinedSize.DiskSize;
+			});
+		break;
+	default:
+		HardCycles.Sort([](const FAssetDependencyCycle& Cycle1, const FAssetDependencyCycle& Cycle2) {
+			return Cycle1.Nodes.Num() > Cycle2.Nodes.Num();
+			});
+		break;
+	}
+
+	CastToCycleIndex = INDEX_NONE;
+}
+
+void FAssetInvestigatorModule::DisplayHardCycles()
+{
+	// Tree nodes can not be clipped, keep the list responsive on projects with thousands of cycles
+	static const int32 MaxDisplayedCycles = 200;
+
+	if (ImGui::Button("FindCycles"))
+	{
+		FindHardCycles();
+	}
+	ImGui::SameLine();
+
+	if (ImGui::Button("ExportCyclesToText"))
+	{
+		AssetInvestigatorUtility::ExportCyclesToTxt(HardCycles, DependencyGraph);
+	}
+
+	if (HardCycles.Num() == 0 || !ImGui::CollapsingHeader("Hard Reference Cycles"))
+	{
+		return;
+	}
+
+	if (ImGui::Combo("SortCyclesBy", &CycleSortMode, "Memory\0Disk\0Packages\0"))
+	{
+		SortHardCycles();
+	}
+
+	if (CycleSortMode == 0 && bHasUnknownCycleMemory)
+	{
+		ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.2f, 1.0f), "Some cycles were not measured, sorted by disk instead. Collect their assets and find cycles again to sort by memory");
+	}
+
+	ImGui::Text("%d cycles", HardCycles.Num());
+
+	for (int32 CycleIndex = 0; CycleIndex < HardCycles.Num() && CycleIndex < MaxDisplayedCycles; CycleIndex++)
+	{
+		const FAssetDependencyCycle& Cycle = HardCycles[CycleIndex];
+
+		ImGui::PushID(CycleIndex);
+
+		if (ImGui::TreeNode("Cycle", "%d packages, %s, disk %s", Cycle.Nodes.Num(),
+			TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(Cycle.CombinedSize.MemorySize, Cycle.CombinedSize.bHasKnownMemorySize)),
+			TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(Cycle.CombinedSize.DiskSize, true))))
+		{
+			for (const TPair<int32, int32>& Edge : Cycle.Edges)
+			{
+				ImGui::BulletText("%s -> %s", TCHAR_TO_ANSI(*DependencyGraph.GetPackageName(Edge.Key).ToString()), TCHAR_TO_ANSI(*DependencyGraph.GetPackageName(Edge.Value).ToString()));
+			}
+
+			if (ImGui::SmallButton("Bring <CastTo> Nodes"))
+			{
+				TArray<FName> PackageNames;
+				for (const int32 NodeIndex : Cycle.Nodes)
+				{
+					PackageNames.Add(DependencyGraph.GetPackageName(NodeIndex));
+				}
+
+				CycleCastToNodes = AssetInvestigatorUtility::GetCyclicCastToNodes(PackageNames);
+				CastToCycleIndex = CycleIndex;
+			}
+
+			if (CastToCycleIndex == CycleIndex)
+			{
+				DisplayCastToNodes(CycleCastToNodes);
+			}
+
+			ImGui::TreePop();
+		}
+
+		ImGui::PopID();
+	}
+}
+
+void FAssetInvestigatorModule::DisplayDuplicateAssets()
+{
+	static const int32 MaxDisplayedGroups = 200;
+
+	if (ImGui::Button("FindDuplicates"))
+	{
+		DuplicateFinder.FindDuplicates(DuplicateGroups);
+
+		if (CachedAssets.Num() > 0)
+		{
+			UpdateDuplicateSizes();
+		}
+	}
+
+	if (DuplicateGroups.Num() == 0 || !ImGui::CollapsingHeader("Duplicate Assets"))
+	{
+		return;
+	}
+
+	int64 TotalWastedSize = 0;
+	for (const FAssetDuplicateGroup& Group : DuplicateGroups)
+	{
+		TotalWastedSize += Group.WastedSize;
+	}
+
+	ImGui::Text("%d groups, %s wasted on disk", DuplicateGroups.Num(), TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(TotalWastedSize, true)));
+
+	if (DuplicateFinder.GetNumSkippedWithoutBulkData() > 0)
+	{
+		ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.2f, 1.0f), "%d assets have no bulk data and were not compared, copies of them are not listed",
+			DuplicateFinder.GetNumSkippedWithoutBulkData());
+	}
+
+	for (int32 GroupIndex = 0; GroupIndex < DuplicateGroups.Num() && GroupIndex < MaxDisplayedGroups; GroupIndex++)
+	{
+		const FAssetDuplicateGroup& Group = DuplicateGroups[GroupIndex];
+
+		ImGui::PushID(GroupIndex);
+
+		if (ImGui::TreeNode("Group", "%s, %d copies, %s wasted, package %s", TCHAR_TO_ANSI(*Group.ClassName.ToString()), Group.PackageNames.Num(),
+			TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(Group.WastedSize, true)),
+			TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(Group.PackageSize, true))))
+		{
+			for (const FName& PackageName : Group.PackageNames)
+			{
+				if (ImGui::Selectable(TCHAR_TO_ANSI(*PackageName.ToString())))
+				{
+					IAssetManagerEditorModule::Get().OpenReferenceViewerUI({ FAssetIdentifier(PackageName) });
+				}
+			}
+
+			ImGui::TreePop();
+		}
+
+		ImGui::PopID();
+	}
+}
+
+void FAssetInvestigatorModule::FindUnreferencedPackages()
+{
+	if (DependencyGraph.Num() == 0)
+	{
+		BuildDependencyGraph();
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<int32> Roots;
+	AssetInvestigatorUtility::GatherCookRoots(DependencyGraph, Roots);
+
+	TArray<int32> Unreachable;
+	AssetDependencyAnalysis::FindUnreachable(DependencyGraph, Roots, Unreachable);
+
+	// Engine and plugin content is not ours to clean up
+	UnreferencedPackages.Reset();
+	UnreferencedDiskSize = 0;
+
+	for (const int32 NodeIndex : Unreachable)
+	{
+		TStringBuilder<256> PackageName;
+		DependencyGraph.GetPackageName(NodeIndex).AppendString(PackageName);
+
+		if (PackageName.ToView().StartsWith(TEXT("/Game/")))
+		{
+			UnreferencedPackages.Add(NodeIndex);
+			UnreferencedDiskSize += DependencyGraph.GetDiskSize(NodeIndex);
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Found %d unreferenced packages from %d roots in %.3f seconds"), UnreferencedPackages.Num(), Roots.Num(), FPlatformTime::Seconds() - StartTime);
+}
+
+void FAssetInvestigatorModule::DisplayUnreferencedPackages()
+{
+	static const int32 MaxDisplayedPackages = 500;
+
+	if (ImGui::Button("FindUnreferenced"))
+	{
+		FindUnreferencedPackages();
+	}
+	ImGui::SameLine();
+
+	if (ImGui::Button("ExportUnreferencedToText"))
+	{
+		AssetInvestigatorUtility::ExportUnreferencedToTxt(UnreferencedPackages, DependencyGraph);
+	}
+
+	if (UnreferencedPackages.Num() == 0 || !ImGui::CollapsingHeader("Unreferenced Packages"))
+	{
+		return;
+	}
+
+	ImGui::Text("%d packages, %s on disk", UnreferencedPackages.Num(), TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(UnreferencedDiskSize, true)));
+
+	ImGui::BeginChild("UnreferencedPackages", ImVec2(0, 200), true);
+
+	for (int32 i = 0; i < UnreferencedPackages.Num() && i < MaxDisplayedPackages; i++)
+	{
+		const int32 NodeIndex = UnreferencedPackages[i];
+
+		char label[512];
+		sprintf(label, "%s, %s", TCHAR_TO_ANSI(*DependencyGraph.GetPackageName(NodeIndex).ToString()), TCHAR_TO_ANSI(*AssetInvestigatorUtility::MakeBestSizeString(DependencyGraph.GetDiskSize(NodeIndex), true)));
+
+		if (ImGui::Selectable(label))
+		{
+			IAssetManagerEditorModule::Get().OpenReferenceViewerUI({ FAssetIdentifier(DependencyGraph.GetPackageName(NodeIndex)) });
+		}
+	}
+
+	ImGui::EndChild();
+}
+
+void FAssetInvestigatorModule::UpdateDuplicateSizes()
+{
+	// Group of every graph node that has an identical copy somewhere else
+	TArray<int32> NodeGroups;
+	NodeGroups.Init(INDEX_NONE, DependencyGraph.Num());
+
+	for (int32 GroupIndex = 0; GroupIndex < DuplicateGroups.Num(); GroupIndex++)
+	{
+		for (const FName& PackageName : DuplicateGroups[GroupIndex].PackageNames)
+		{
+			const int32 NodeIndex = DependencyGraph.FindNode(PackageName);
+			if (NodeIndex != INDEX_NONE)
+			{
+				NodeGroups[NodeIndex] = GroupIndex;
+			}
+		}
+	}
+
+	TArray<int32> Closure;
+	TMap<int32, int32> CopiesPerGroup;
+
+	// Only copies that end up in the same closure are paid for twice by that root
+	for (int32 Row = 0; Row < CachedAssets.Num(); Row++)
+	{
+		DependencyGraph.GatherHardClosure(CachedAssets.GetPackageNode(Row), Closure);
+
+		CopiesPerGroup.Reset();
+		for (const int32 NodeIndex : Closure)
+		{
+			if (NodeGroups[NodeIndex] != INDEX_NONE)
+			{
+				CopiesPerGroup.FindOrAdd(NodeGroups[NodeIndex])++;
+			}
+		}
+
+		int64 DuplicateSize = 0;
+		for (const TPair<int32, int32>& Copies : CopiesPerGroup)
+		{
+			DuplicateSize += DuplicateGroups[Copies.Key].PayloadSize * (Copies.Value - 1);
+		}
+
+		CachedAssets.SetDuplicateSize(Row, DuplicateSize);
+	}
+}
+
+int64 FAssetInvestigatorModule::GetRankingSize(const int32 NodeIndex) const
+{
+	return bCachedAssetsAreCooked ? DependencyGraph.GetDiskSize(NodeIndex) : FMath::Max<int64>(DependencyGraph.GetMemorySize(NodeIndex), 0);
+}
+
 void FAssetInvestigatorModule::PluginButtonClicked()
 {
 	FGlobalTabmanager::Get()->TryInvokeTab(AssetInvestigatorTabName);
@@ -0,0 +1,684 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetInvestigatorCommandlet.h"
+#include "AssetData.h"
+#include "AssetInfo.h"
+#include "AssetDependencyGraph.h"
+#include "AssetInvestigatorUtility.h"
+#include "CookedAssetRegistry.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/AssetRegistryState.h"
+#include "Engine/Blueprint.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UObjectHash.h"
+
+namespace AssetInvestigatorCommandletPrivate
+{
+	/** How long the driver sleeps between polls of its shard processes */
+	static const float ShardPollInterval = 1.0f;
+
+	/** Returned by a shard that stopped at its memory cap, the driver measures the rest in a fresh process */
+	static const int32 ShardMemoryCapExitCode = 2;
+
+	/** What a shard is assumed to need when the number of parallel shards is derived without -MaxMemoryMB */
+	static const int32 DefaultShardMemoryMB = 4096;
+
+	/**
+	 * Rebuilds the graph from the editor registry and gathers every /Game Blueprint, sorted so runs are repeatable.
+	 * Only the driver does this, shards are handed their package lists and never search the registry.
+	 */
+	void GatherEditorRoots(FAssetDependencyGraph& Graph, TArray<FAssetData>& OutRootAssets)
+	{
+		IAssetRegistry& AssetRegistry = FAssetRegistryModule::GetRegistry();
+		AssetRegistry.SearchAllAssets(true);
+
+		AssetInvestigatorUtility::BuildEditorDependencyGraph(Graph);
+
+		FARFilter Filter;
+		Filter.bRecursivePaths = true;
+		Filter.ClassNames.Add(UBlueprint::StaticClass()->GetFName());
+		Filter.PackagePaths.Add("/Game");
+
+		AssetRegistry.GetAssets(Filter, OutRootAssets);
+
+		OutRootAssets.Sort([](const FAssetData& Asset1, const FAssetData& Asset2) {
+			return Asset1.ObjectPath.LexicalLess(Asset2.ObjectPath);
+			});
+	}
+
+	/** Gathers the union of the roots' hard closures, sorted by package name so runs measure in the same order */
+	void GatherPackagesToMeasure(const FAssetDependencyGraph& Graph, const TArray<FAssetData>& RootAssets, TArray<int32>& OutNodes)
+	{
+		TBitArray<> Added(false, Graph.Num());
+		TArray<int32> Closure;
+
+		for (const FAssetData& RootAsset : RootAssets)
+		{
+			const int32 RootNode = Graph.FindNode(RootAsset.PackageName);
+			if (RootNode == INDEX_NONE)
+			{
+				continue;
+			}
+
+			Graph.GatherHardClosure(RootNode, Closure);
+
+			for (const int32 NodeIndex : Closure)
+			{
+				if (!Added[NodeIndex])
+				{
+					Added[NodeIndex] = true;
+					OutNodes.Add(NodeIndex);
+				}
+			}
+		}
+
+		OutNodes.Sort([&Graph](const int32 Node1, const int32 Node2) {
+			return Graph.GetPackageName(Node1).LexicalLess(Graph.GetPackageName(Node2));
+			});
+	}
+
+	/**
+	 * Splits the union of the roots' hard closures into at most ShardCount lists of similar disk size.
+	 * A package only one root reaches stays in that root's list, so a root's own content is loaded by a single shard.
+	 * Shared packages, e.g. common materials and base Blueprints that would otherwise tie every root together, are measured
+	 * once by the lightest shard that loads them anyway as a dependency of one of its roots.
+	 */
+	void PartitionPackages(const FAssetDependencyGraph& Graph, const TArray<FAssetData>& RootAssets, const int32 ShardCount, TArray<TArray<int32>>& OutShards)
+	{
+		TArray<int32> RootNodes;
+		TBitArray<> IsRootNode(false, Graph.Num());
+		for (const FAssetData& RootAsset : RootAssets)
+		{
+			const int32 RootNode = Graph.FindNode(RootAsset.PackageName);
+			if (RootNode != INDEX_NONE && !IsRootNode[RootNode])
+			{
+				IsRootNode[RootNode] = true;
+				RootNodes.Add(RootNode);
+			}
+		}
+
+		// The first root reaching a package owns it until a second root reaches it too
+		static const int32 SharedOwner = -2;
+
+		TArray<int32> Owners;
+		Owners.Init(INDEX_NONE, Graph.Num());
+
+		TArray<int32> Closure;
+		for (int32 RootIndex = 0; RootIndex < RootNodes.Num(); RootIndex++)
+		{
+			Graph.GatherHardClosure(RootNodes[RootIndex], Closure);
+
+			for (const int32 NodeIndex : Closure)
+			{
+				Owners[NodeIndex] = Owners[NodeIndex] == INDEX_NONE || Owners[NodeIndex] == RootIndex ? RootIndex : SharedOwner;
+			}
+		}
+
+		// Disk size stands in for load time, the only cost known before loading
+		auto GetWeight = [&Graph](const int32 NodeIndex)
+		{
+			return FMath::Max<int64>(Graph.GetDiskSize(NodeIndex), 1);
+		};
+
+		TArray<TArray<int32>> RootPackages;
+		TArray<int64> RootWeights;
+		RootPackages.SetNum(RootNodes.Num());
+		RootWeights.SetNumZeroed(RootNodes.Num());
+
+		TArray<int32> SharedNodes;
+		for (int32 NodeIndex = 0; NodeIndex < Graph.Num(); NodeIndex++)
+		{
+			if (Owners[NodeIndex] == SharedOwner)
+			{
+				SharedNodes.Add(NodeIndex);
+			}
+			else if (Owners[NodeIndex] != INDEX_NONE)
+			{
+				RootPackages[Owners[NodeIndex]].Add(NodeIndex);
+				RootWeights[Owners[NodeIndex]] += GetWeight(NodeIndex);
+			}
+		}
+
+		// Largest first onto the lightest shard keeps the slowest shard close to the average
+		TArray<int32> RootOrder;
+		for (int32 RootIndex = 0; RootIndex < RootNodes.Num(); RootIndex++)
+		{
+			RootOrder.Add(RootIndex);
+		}
+
+		RootOrder.StableSort([&RootWeights](const int32 Root1, const int32 Root2) {
+			return RootWeights[Root1] > RootWeights[Root2];
+			});
+
+		OutShards.Reset();
+		OutShards.SetNum(FMath::Clamp(ShardCount, 1, FMath::Max(RootNodes.Num(), 1)));
+
+		TArray<int64> ShardWeights;
+		ShardWeights.SetNumZeroed(OutShards.Num());
+
+		auto FindLightestShard = [&ShardWeights](TArrayView<const int32> Candidates)
+		{
+			int32 LightestShard = Candidates[0];
+			for (const int32 ShardIndex : Candidates)
+			{
+				if (ShardWeights[ShardIndex] < ShardWeights[LightestShard])
+				{
+					LightestShard = ShardIndex;
+				}
+			}
+			return LightestShard;
+		};
+
+		TArray<int32> AllShards;
+		for (int32 ShardIndex = 0; ShardIndex < OutShards.Num(); ShardIndex++)
+		{
+			AllShards.Add(ShardIndex);
+		}
+
+		TArray<int32> RootShards;
+		RootShards.SetNumUninitialized(RootNodes.Num());
+
+		for (const int32 RootIndex : RootOrder)
+		{
+			const int32 ShardIndex = FindLightestShard(AllShards);
+			RootShards[RootIndex] = ShardIndex;
+			OutShards[ShardIndex].Append(RootPackages[RootIndex]);
+			ShardWeights[ShardIndex] += RootWeights[RootIndex];
+		}
+
+		// Every shard that has a root reaching a shared package loads it anyway, the lightest of them measures it
+		TArray<TArray<int32, TInlineAllocator<4>>> ShardsLoading;
+		ShardsLoading.SetNum(Graph.Num());
+
+		for (int32 RootIndex = 0; RootIndex < RootNodes.Num(); RootIndex++)
+		{
+			Graph.GatherHardClosure(RootNodes[RootIndex], Closure);
+
+			for (const int32 NodeIndex : Closure)
+			{
+				if (Owners[NodeIndex] == SharedOwner)
+				{
+					ShardsLoading[NodeIndex].AddUnique(RootShards[RootIndex]);
+				}
+			}
+		}
+
+		SharedNodes.StableSort([&GetWeight](const int32 Node1, const int32 Node2) {
+			return GetWeight(Node1) > GetWeight(Node2);
+			});
+
+		for (const int32 NodeIndex : SharedNodes)
+		{
+			const int32 ShardIndex = FindLightestShard(ShardsLoading[NodeIndex]);
+			OutShards[ShardIndex].Add(NodeIndex);
+			ShardWeights[ShardIndex] += GetWeight(NodeIndex);
+		}
+
+		OutShards.RemoveAll([](const TArray<int32>& Nodes) {
+			return Nodes.Num() == 0;
+			});
+	}
+
+	/** How many shards run at once by default: no more than there are cores, nor than fit in free memory at their cap */
+	int32 GetDefaultMaxParallelShards(const int32 MaxMemoryMB)
+	{
+		const uint64 ShardMemoryBytes = (uint64)(MaxMemoryMB > 0 ? MaxMemoryMB : DefaultShardMemoryMB) * 1024 * 1024;
+		const int32 NumFittingShards = (int32)FMath::Min<uint64>(FPlatformMemory::GetStats().AvailablePhysical / ShardMemoryBytes, MAX_int32);
+
+		return FMath::Max(1, FMath::Min(FPlatformMisc::NumberOfCores(), NumFittingShards));
+	}
+
+	/**
+	 * Loads a package and sums its assets, the same top level objects the registry would list for it.
+	 *
+	 * @return The memory size, FAssetDependencyGraph::UnknownSize if the package failed to load.
+	 */
+	int64 MeasurePackage(const FName& PackageName)
+	{
+		UPackage* Package = LoadPackage(nullptr, *PackageName.ToString(), LOAD_NoWarn | LOAD_Quiet);
+		if (!Package)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Failed to load %s, its memory stays unknown"), *PackageName.ToString());
+			return FAssetDependencyGraph::UnknownSize;
+		}
+
+		int64 MemorySize = 0;
+		ForEachObjectWithPackage(Package, [&MemorySize](UObject* Object)
+			{
+				if (Object->IsAsset())
+				{
+					MemorySize += Object->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+				}
+				return true;
+			}, false);
+
+		return MemorySize;
+	}
+
+	/**
+	 * Loads and measures the packages in order. Before each load a process over MaxMemoryMB collects and purges garbage,
+	 * nothing measured is referenced afterwards so that drops everything loaded so far.
+	 *
+	 * @return The number of packages measured, fewer than given if the process was still over the cap after collecting.
+	 */
+	int32 MeasurePackages(TArrayView<const FName> PackageNames, const int32 MaxMemoryMB, TArray<int64>& OutMemorySizes)
+	{
+		const uint64 MaxMemoryBytes = (uint64)FMath::Max(MaxMemoryMB, 0) * 1024 * 1024;
+
+		OutMemorySizes.Reset(PackageNames.Num());
+
+		for (int32 i = 0; i < PackageNames.Num(); i++)
+		{
+			if (MaxMemoryBytes > 0 && FPlatformMemory::GetStats().UsedPhysical > MaxMemoryBytes)
+			{
+				CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+				GMalloc->Trim(true);
+
+				const uint64 UsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+				if (UsedPhysical > MaxMemoryBytes)
+				{
+					UE_LOG(LogTemp, Warning, TEXT("Still using %llu MB after collecting garbage, over the %d MB cap, stopping after %d of %d packages"),
+						UsedPhysical / (1024 * 1024), MaxMemoryMB, i, PackageNames.Num());
+					break;
+				}
+			}
+
+			OutMemorySizes.Add(MeasurePackage(PackageNames[i]));
+
+			if (i % 1000 == 0)
+			{
+				UE_LOG(LogTemp, Display, TEXT("Measured %d / %d packages"), i, PackageNames.Num());
+			}
+		}
+
+		return OutMemorySizes.Num();
+	}
+
+	/** One package name per line */
+	bool SaveShardInput(const TArray<FName>& PackageNames, const FString& ShardInputPath)
+	{
+		TArray<FString> Lines;
+		Lines.Reserve(PackageNames.Num());
+
+		for (const FName& PackageName : PackageNames)
+		{
+			Lines.Add(PackageName.ToString());
+		}
+
+		return FFileHelper::SaveStringArrayToFile(Lines, *ShardInputPath);
+	}
+
+	/** One line per measured package: PackageName<Tab>MemorySize, with FAssetDependencyGraph::UnknownSize for packages that failed to load */
+	bool SaveShardOutput(TArrayView<const FName> PackageNames, TArrayView<const int64> MemorySizes, const FString& ShardOutputPath)
+	{
+		TArray<FString> Lines;
+		Lines.Reserve(MemorySizes.Num());
+
+		for (int32 i = 0; i < MemorySizes.Num(); i++)
+		{
+			Lines.Add(FString::Printf(TEXT("%s\t%lld"), *PackageNames[i].ToString(), MemorySizes[i]));
+		}
+
+		return FFileHelper::SaveStringArrayToFile(Lines, *ShardOutputPath);
+	}
+
+	/**
+	 * Applies a shard's measurements to the graph, packages the graph does not know are ignored
+	 * and packages that failed to load stay at FAssetDependencyGraph::UnknownSize.
+	 *
+	 * @return The number of packages the shard got to, loaded or not, INDEX_NONE if it wrote no output.
+	 */
+	int32 LoadShardOutput(FAssetDependencyGraph& Graph, const FString& ShardOutputPath)
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *ShardOutputPath))
+		{
+			return INDEX_NONE;
+		}
+
+		int32 NumMeasured = 0;
+		for (const FString& Line : Lines)
+		{
+			FString PackageName;
+			FString MemorySize;
+			if (!Line.Split(TEXT("\t"), &PackageName, &MemorySize))
+			{
+				continue;
+			}
+
+			const int32 NodeIndex = Graph.FindNode(FName(*PackageName));
+			const int64 MeasuredSize = FCString::Atoi64(*MemorySize);
+			if (NodeIndex != INDEX_NONE && MeasuredSize >= 0)
+			{
+				Graph.SetMemorySize(NodeIndex, MeasuredSize);
+			}
+
+			NumMeasured++;
+		}
+
+		return NumMeasured;
+	}
+
+	/**
+	 * Measures every package list in its own copy of this commandlet, at most MaxParallelShards at a time, and merges the results into the graph.
+	 * A shard that stops at its memory cap has the rest of its list measured by a fresh process, one that measured nothing is given up on.
+	 * The lists are disjoint, so every package is measured once and the merge does not depend on which shard finished first.
+	 */
+	bool RunShards(FAssetDependencyGraph& Graph, const TArray<TArray<int32>>& ShardNodes, const int32 MaxParallelShards, const int32 MaxMemoryMB, const FString& ShardDirectory)
+	{
+		IFileManager::Get().MakeDirectory(*ShardDirectory, true);
+
+		const FString ProjectPath = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+
+		struct FShardJob
+		{
+			TArray<FName> PackageNames;
+			FProcHandle Process;
+			double StartTime = 0.0;
+		};
+
+		TArray<FShardJob> Jobs;
+		for (const TArray<int32>& Nodes : ShardNodes)
+		{
+			FShardJob& Job = Jobs.AddDefaulted_GetRef();
+			for (const int32 NodeIndex : Nodes)
+			{
+				Job.PackageNames.Add(Graph.GetPackageName(NodeIndex));
+			}
+		}
+
+		auto GetShardPath = [&ShardDirectory](const int32 JobIndex, const TCHAR* Extension)
+		{
+			return FPaths::Combine(ShardDirectory, FString::Printf(TEXT("Shard_%d.%s"), JobIndex, Extension));
+		};
+
+		auto StartShard = [&](const int32 JobIndex)
+		{
+			FShardJob& Job = Jobs[JobIndex];
+
+			const FString ShardInputPath = GetShardPath(JobIndex, TEXT("input"));
+			const FString ShardOutputPath = GetShardPath(JobIndex, TEXT("txt"));
+			IFileManager::Get().Delete(*ShardOutputPath, false, true, true);
+
+			if (!SaveShardInput(Job.PackageNames, ShardInputPath))
+			{
+				return false;
+			}
+
+			const FString ShardParams = FString::Printf(TEXT("\"%s\" -run=AssetInvestigator -Exact -ShardInput=\"%s\" -ShardOutput=\"%s\" -MaxMemoryMB=%d -abslog=\"%s\" -unattended -nopause -nullrhi -nosplash"),
+				*ProjectPath, *ShardInputPath, *ShardOutputPath, MaxMemoryMB, *GetShardPath(JobIndex, TEXT("log")));
+
+			Job.StartTime = FPlatformTime::Seconds();
+			Job.Process = FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *ShardParams, false, true, true, nullptr, 0, nullptr, nullptr);
+
+			return Job.Process.IsValid();
+		};
+
+		const double StartTime = FPlatformTime::Seconds();
+		bool bAllShardsSucceeded = true;
+
+		TArray<int32> RunningJobs;
+		int32 NextJob = 0;
+
+		while (NextJob < Jobs.Num() || RunningJobs.Num() > 0)
+		{
+			while (NextJob < Jobs.Num() && RunningJobs.Num() < MaxParallelShards)
+			{
+				if (StartShard(NextJob))
+				{
+					RunningJobs.Add(NextJob);
+				}
+				else
+				{
+					UE_LOG(LogTemp, Error, TEXT("Failed to start shard %d, its %d packages stay unmeasured"), NextJob, Jobs[NextJob].PackageNames.Num());
+					bAllShardsSucceeded = false;
+				}
+
+				NextJob++;
+			}
+
+			FPlatformProcess::Sleep(ShardPollInterval);
+
+			for (int32 i = RunningJobs.Num() - 1; i >= 0; i--)
+			{
+				const int32 JobIndex = RunningJobs[i];
+				if (FPlatformProcess::IsProcRunning(Jobs[JobIndex].Process))
+				{
+					continue;
+				}
+
+				RunningJobs.RemoveAtSwap(i, 1, false);
+
+				int32 ReturnCode = 0;
+				FPlatformProcess::GetProcReturnCode(Jobs[JobIndex].Process, &ReturnCode);
+				FPlatformProcess::CloseProc(Jobs[JobIndex].Process);
+
+				const double WallTime = FPlatformTime::Seconds() - Jobs[JobIndex].StartTime;
+				const int32 NumPackages = Jobs[JobIndex].PackageNames.Num();
+				const int32 NumMeasured = ReturnCode == 0 || ReturnCode == ShardMemoryCapExitCode ? LoadShardOutput(Graph, GetShardPath(JobIndex, TEXT("txt"))) : INDEX_NONE;
+
+				if (ReturnCode == 0 && NumMeasured == NumPackages)
+				{
+					UE_LOG(LogTemp, Display, TEXT("Merged %d packages from shard %d, %.1f s wall time"), NumMeasured, JobIndex, WallTime);
+				}
+				else if (ReturnCode == ShardMemoryCapExitCode && NumMeasured > 0 && NumMeasured < NumPackages)
+				{
+					TArray<FName> Remaining(Jobs[JobIndex].PackageNames.GetData() + NumMeasured, NumPackages - NumMeasured);
+					Jobs.AddDefaulted_GetRef().PackageNames = MoveTemp(Remaining);
+
+					UE_LOG(LogTemp, Warning, TEXT("Shard %d reached its memory cap after %d of %d packages in %.1f s, the rest goes to shard %d"),
+						JobIndex, NumMeasured, NumPackages, WallTime, Jobs.Num() - 1);
+				}
+				else
+				{
+					UE_LOG(LogTemp, Error, TEXT("Shard %d failed with code %d after %.1f s, %d of its %d packages stay unmeasured"),
+						JobIndex, ReturnCode, WallTime, NumPackages - FMath::Max(NumMeasured, 0), NumPackages);
+					bAllShardsSucceeded = false;
+				}
+			}
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("Ran %d shard processes, at most %d at a time, in %.1f s wall time"), Jobs.Num(), MaxParallelShards, FPlatformTime::Seconds() - StartTime);
+
+		return bAllShardsSucceeded;
+	}
+}
+
+UAssetInvestigatorCommandlet::UAssetInvestigatorCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UAssetInvestigatorCommandlet::Main(const FString& Params)
+{
+	if (FParse::Param(*Params, TEXT("Exact")))
+	{
+		return RunExactCollection(Params);
+	}
+
+	FString PlatformName = TEXT("WindowsNoEditor");
+	FParse::Value(*Params, TEXT("Platform="), PlatformName);
+
+	FString RegistryPath;
+	if (!FParse::Value(*Params, TEXT("Registry="), RegistryPath))
+	{
+		RegistryPath = FCookedAssetRegistry::GetDevelopmentRegistryPath(PlatformName);
+	}
+
+	FString ReportPath;
+	if (!FParse::Value(*Params, TEXT("Report="), ReportPath))
+	{
+		ReportPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("AssetInvestigator"), PlatformName + TEXT("_CookedReport.txt"));
+	}
+
+	FCookedAssetRegistry CookedRegistry;
+	if (!CookedRegistry.LoadDevelopmentRegistry(RegistryPath))
+	{
+		return 1;
+	}
+
+	FString ListingPath;
+	if (FParse::Value(*Params, TEXT("PakList="), ListingPath))
+	{
+		CookedRegistry.LoadPackageListing(ListingPath);
+	}
+
+	FAssetDependencyGraph Graph;
+	Graph.Build(CookedRegistry.GetState(), &CookedRegistry.GetPackageSizes());
+
+	TArray<const FAssetData*> RootAssets;
+	CookedRegistry.GatherRootAssets(RootAssets);
+
+	FAssetInfoTable AssetInfoList;
+
+	TArray<int32> Closure;
+	for (const FAssetData* RootAsset : RootAssets)
+	{
+		const int32 RootNode = Graph.FindNode(RootAsset->PackageName);
+		if (RootNode == INDEX_NONE)
+		{
+			continue;
+		}
+
+		Graph.GatherHardClosure(RootNode, Closure);
+
+		AssetInfoList.Add(RootAsset->ObjectPath, RootNode, Graph.SumSizes(Closure), Graph.GetHardDependencies(RootNode));
+	}
+
+	AssetInfoList.SortByDiskSize();
+
+	UE_LOG(LogTemp, Display, TEXT("Measured %d Blueprint closures over %d cooked packages (%d without a listed size), writing %s"), AssetInfoList.Num(), Graph.Num(),
+		Graph.GetNumDiskSizeFallbacks(), *ReportPath);
+
+	AssetInvestigatorUtility::ExportListToTxt(AssetInfoList, ReportPath);
+
+	return 0;
+}
+
+int32 UAssetInvestigatorCommandlet::RunExactCollection(const FString& Params)
+{
+	using namespace AssetInvestigatorCommandletPrivate;
+
+	int32 MaxMemoryMB = 0;
+	FParse::Value(*Params, TEXT("MaxMemoryMB="), MaxMemoryMB);
+
+	// A shard measures the packages the driver listed for it and leaves the report to the driver
+	FString ShardInputPath;
+	if (FParse::Value(*Params, TEXT("ShardInput="), ShardInputPath))
+	{
+		FString ShardOutputPath;
+		TArray<FString> Lines;
+		if (!FParse::Value(*Params, TEXT("ShardOutput="), ShardOutputPath) || !FFileHelper::LoadFileToStringArray(Lines, *ShardInputPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("A shard needs -ShardInput=<path> -ShardOutput=<path>"));
+			return 1;
+		}
+
+		TArray<FName> PackageNames;
+		PackageNames.Reserve(Lines.Num());
+		for (const FString& Line : Lines)
+		{
+			PackageNames.Add(FName(*Line));
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		TArray<int64> MemorySizes;
+		const int32 NumMeasured = MeasurePackages(PackageNames, MaxMemoryMB, MemorySizes);
+
+		UE_LOG(LogTemp, Display, TEXT("Shard measured %d of %d packages in %.1f s"), NumMeasured, PackageNames.Num(), FPlatformTime::Seconds() - StartTime);
+
+		if (!SaveShardOutput(PackageNames, MemorySizes, ShardOutputPath))
+		{
+			return 1;
+		}
+
+		return NumMeasured == PackageNames.Num() ? 0 : ShardMemoryCapExitCode;
+	}
+
+	FAssetDependencyGraph Graph;
+	TArray<FAssetData> RootAssets;
+	GatherEditorRoots(Graph, RootAssets);
+
+	TArray<int32> PackagesToMeasure;
+	GatherPackagesToMeasure(Graph, RootAssets, PackagesToMeasure);
+
+	FString ReportPath;
+	if (!FParse::Value(*Params, TEXT("Report="), ReportPath))
+	{
+		ReportPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("AssetInvestigator"), TEXT("ExactReport.txt"));
+	}
+
+	int32 ShardCount = 1;
+	FParse::Value(*Params, TEXT("Shards="), ShardCount);
+
+	bool bMeasuredEverything = true;
+	if (ShardCount > 1)
+	{
+		int32 MaxParallelShards = GetDefaultMaxParallelShards(MaxMemoryMB);
+		FParse::Value(*Params, TEXT("MaxParallelShards="), MaxParallelShards);
+
+		TArray<TArray<int32>> ShardNodes;
+		PartitionPackages(Graph, RootAssets, ShardCount, ShardNodes);
+
+		bMeasuredEverything = RunShards(Graph, ShardNodes, FMath::Max(MaxParallelShards, 1), MaxMemoryMB, FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("AssetInvestigator"), TEXT("Shards")));
+	}
+	else
+	{
+		TArray<FName> PackageNames;
+		PackageNames.Reserve(PackagesToMeasure.Num());
+		for (const int32 NodeIndex : PackagesToMeasure)
+		{
+			PackageNames.Add(Graph.GetPackageName(NodeIndex));
+		}
+
+		TArray<int64> MemorySizes;
+		const int32 NumMeasured = MeasurePackages(PackageNames, MaxMemoryMB, MemorySizes);
+
+		for (int32 i = 0; i < NumMeasured; i++)
+		{
+			if (MemorySizes[i] >= 0)
+			{
+				Graph.SetMemorySize(PackagesToMeasure[i], MemorySizes[i]);
+			}
+		}
+
+		if (NumMeasured < PackagesToMeasure.Num())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Stopped at the memory cap after %d of %d packages, split the measurement with -Shards"), NumMeasured, PackagesToMeasure.Num());
+			bMeasuredEverything = false;
+		}
+	}
+
+	FAssetInfoTable AssetInfoList;
+
+	TArray<int32> Closure;
+	for (const FAssetData& RootAsset : RootAssets)
+	{
+		const int32 RootNode = Graph.FindNode(RootAsset.PackageName);
+		if (RootNode == INDEX_NONE)
+		{
+			continue;
+		}
+
+		Graph.GatherHardClosure(RootNode, Closure);
+
+		AssetInfoList.Add(RootAsset.ObjectPath, RootNode, Graph.SumSizes(Closure), Graph.GetHardDependencies(RootNode));
+	}
+
+	AssetInfoList.SortByMemorySize();
+
+	UE_LOG(LogTemp, Display, TEXT("Measured %d Blueprint closures over %d packages, writing %s"), AssetInfoList.Num(), PackagesToMeasure.Num(), *ReportPath);
+
+	AssetInvestigatorUtility::ExportListToTxt(AssetInfoList, ReportPath);
+
+	return bMeasuredEverything ? 0 : 1;
+}
@@ -0,0 +1,342 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetInvestigatorSubsystem.h"
+#include "AssetDependencyGraph.h"
+#include "AssetDependencyAnalysis.h"
+#include "AssetInvestigatorUtility.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+
+namespace AssetInvestigatorSubsystemPrivate
+{
+	FAssetInvestigatorSizeResult MakeSizeResult(const FAssetDependencyGraph& Graph, const int32 Node, const int32 NumPackages, const FAssetSizeInfo& AssetSizeInfo)
+	{
+		FAssetInvestigatorSizeResult Result;
+		Result.PackageName = Graph.GetPackageName(Node);
+		Result.bFound = true;
+		Result.NumPackages = NumPackages;
+		Result.DiskSize = AssetSizeInfo.DiskSize;
+		Result.MemorySize = AssetSizeInfo.MemorySize;
+		Result.bHasKnownMemorySize = AssetSizeInfo.bHasKnownMemorySize;
+		return Result;
+	}
+
+	FAssetInvestigatorSizeResult MakeNotFoundResult(const FName& Asset)
+	{
+		FAssetInvestigatorSizeResult Result;
+		Result.PackageName = Asset;
+		return Result;
+	}
+}
+
+void UAssetInvestigatorSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	IAssetRegistry& AssetRegistry = FAssetRegistryModule::GetRegistry();
+	AssetRegistry.OnAssetAdded().AddUObject(this, &UAssetInvestigatorSubsystem::OnAssetChanged);
+	AssetRegistry.OnAssetRemoved().AddUObject(this, &UAssetInvestigatorSubsystem::OnAssetChanged);
+	AssetRegistry.OnAssetUpdated().AddUObject(this, &UAssetInvestigatorSubsystem::OnAssetChanged);
+	AssetRegistry.OnAssetRenamed().AddUObject(this, &UAssetInvestigatorSubsystem::OnAssetRenamed);
+	AssetRegistry.OnFilesLoaded().AddUObject(this, &UAssetInvestigatorSubsystem::RefreshGraph);
+}
+
+void UAssetInvestigatorSubsystem::Deinitialize()
+{
+	if (FModuleManager::Get().IsModuleLoaded("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = FAssetRegistryModule::GetRegistry();
+		AssetRegistry.OnAssetAdded().RemoveAll(this);
+		AssetRegistry.OnAssetRemoved().RemoveAll(this);
+		AssetRegistry.OnAssetUpdated().RemoveAll(this);
+		AssetRegistry.OnAssetRenamed().RemoveAll(this);
+		AssetRegistry.OnFilesLoaded().RemoveAll(this);
+	}
+
+	RegistryGraph.Reset();
+
+	Super::Deinitialize();
+}
+
+void UAssetInvestigatorSubsystem::RefreshGraph()
+{
+	bIsGraphStale = true;
+}
+
+TArray<FAssetInvestigatorSizeResult> UAssetInvestigatorSubsystem::GetClosureSizes(const TArray<FName>& Assets, bool bMeasureMemory)
+{
+	using namespace AssetInvestigatorSubsystemPrivate;
+
+	const FAssetDependencyGraph& Graph = GetGraph();
+
+	TArray<int32> Nodes;
+	ResolveNodes(Graph, Assets, Nodes);
+
+	TArray<FAssetInvestigatorSizeResult> Results;
+	Results.Reserve(Assets.Num());
+
+	// One scratch buffer for the whole batch, the same as a collect
+	TArray<int32> ClosureBuffer;
+	ClosureBuffer.SetNumUninitialized(Graph.Num());
+
+	TArray<uint32> VisitedBits;
+	VisitedBits.SetNumZeroed((Graph.Num() + 31) / 32);
+
+	if (bMeasureMemory)
+	{
+		MeasureClosures(Nodes, ClosureBuffer, VisitedBits);
+	}
+
+	for (int32 i = 0; i < Assets.Num(); i++)
+	{
+		if (Nodes[i] == INDEX_NONE)
+		{
+			Results.Add(MakeNotFoundResult(Assets[i]));
+			continue;
+		}
+
+		const TArrayView<const int32> Closure(ClosureBuffer.GetData(), Graph.GatherHardClosure(Nodes[i], ClosureBuffer, VisitedBits));
+		Results.Add(MakeSizeResult(Graph, Nodes[i], Closure.Num(), Graph.SumSizes(Closure)));
+	}
+
+	return Results;
+}
+
+TArray<FAssetInvestigatorSizeResult> UAssetInvestigatorSubsystem::GetExclusiveSizes(const TArray<FName>& Assets, bool bMeasureMemory)
+{
+	using namespace AssetInvestigatorSubsystemPrivate;
+
+	const FAssetDependencyGraph& Graph = GetGraph();
+
+	TArray<int32> Nodes;
+	ResolveNodes(Graph, Assets, Nodes);
+
+	TArray<int32> FoundNodes;
+	for (const int32 Node : Nodes)
+	{
+		if (Node != INDEX_NONE)
+		{
+			FoundNodes.Add(Node);
+		}
+	}
+
+	if (bMeasureMemory)
+	{
+		TArray<int32> ClosureBuffer;
+		ClosureBuffer.SetNumUninitialized(Graph.Num());
+
+		TArray<uint32> VisitedBits;
+		VisitedBits.SetNumZeroed((Graph.Num() + 31) / 32);
+
+		MeasureClosures(FoundNodes, ClosureBuffer, VisitedBits);
+	}
+
+	TArray<FAssetSizeInfo> ExclusiveSizes;
+	AssetDependencyAnalysis::GatherExclusiveSizes(Graph, FoundNodes, ExclusiveSizes);
+
+	TArray<FAssetInvestigatorSizeResult> Results;
+	Results.Reserve(Assets.Num());
+
+	int32 FoundIndex = 0;
+	for (int32 i = 0; i < Assets.Num(); i++)
+	{
+		if (Nodes[i] == INDEX_NONE)
+		{
+			Results.Add(MakeNotFoundResult(Assets[i]));
+		}
+		else
+		{
+			Results.Add(MakeSizeResult(Graph, Nodes[i], 0, ExclusiveSizes[FoundIndex++]));
+		}
+	}
+
+	return Results;
+}
+
+TArray<FAssetInvestigatorRootsResult> UAssetInvestigatorSubsystem::GetReverseRoots(const TArray<FName>& Assets)
+{
+	const FAssetDependencyGraph& Graph = GetGraph();
+
+	TArray<int32> Nodes;
+	ResolveNodes(Graph, Assets, Nodes);
+
+	TArray<int32> FoundNodes;
+	for (const int32 Node : Nodes)
+	{
+		if (Node != INDEX_NONE)
+		{
+			FoundNodes.Add(Node);
+		}
+	}
+
+	TArray<TArray<int32>> RootNodes;
+	AssetDependencyAnalysis::FindReverseRoots(Graph, FoundNodes, RootNodes);
+
+	TArray<FAssetInvestigatorRootsResult> Results;
+	Results.SetNum(Assets.Num());
+
+	int32 FoundIndex = 0;
+	for (int32 i = 0; i < Assets.Num(); i++)
+	{
+		Results[i].PackageName = Nodes[i] != INDEX_NONE ? Graph.GetPackageName(Nodes[i]) : Assets[i];
+
+		if (Nodes[i] == INDEX_NONE)
+		{
+			continue;
+		}
+
+		for (const int32 RootNode : RootNodes[FoundIndex++])
+		{
+			Results[i].Roots.Add(Graph.GetPackageName(RootNode));
+		}
+
+		Results[i].Roots.Sort(FNameLexicalLess());
+	}
+
+	return Results;
+}
+
+TArray<FAssetInvestigatorPathResult> UAssetInvestigatorSubsystem::FindPathsBetween(const TArray<FName>& From, const TArray<FName>& To)
+{
+	TArray<FAssetInvestigatorPathResult> Results;
+
+	if (From.Num() != To.Num())
+	{
+		UE_LOG(LogTemp, Error, TEXT("FindPathsBetween needs as many From as To assets, got %d and %d"), From.Num(), To.Num());
+		return Results;
+	}
+
+	const FAssetDependencyGraph& Graph = GetGraph();
+
+	TArray<int32> FromNodes;
+	ResolveNodes(Graph, From, FromNodes);
+
+	TArray<int32> ToNodes;
+	ResolveNodes(Graph, To, ToNodes);
+
+	Results.SetNum(From.Num());
+
+	TArray<int32> Path;
+	for (int32 i = 0; i < From.Num(); i++)
+	{
+		Results[i].From = From[i];
+		Results[i].To = To[i];
+
+		if (FromNodes[i] != INDEX_NONE && ToNodes[i] != INDEX_NONE && AssetDependencyAnalysis::FindHardPath(Graph, FromNodes[i], ToNodes[i], Path))
+		{
+			for (const int32 Node : Path)
+			{
+				Results[i].Path.Add(Graph.GetPackageName(Node));
+			}
+		}
+	}
+
+	return Results;
+}
+
+TArray<FAssetInvestigatorSizeResult> UAssetInvestigatorSubsystem::FilterOverBudget(const TArray<FName>& Assets, int64 MaxDiskSize, int64 MaxMemorySize, bool bMeasureMemory)
+{
+	TArray<FAssetInvestigatorSizeResult> Results = GetClosureSizes(Assets, bMeasureMemory);
+
+	const bool bHasDiskBudget = MaxDiskSize > 0;
+	const bool bHasMemoryBudget = MaxMemorySize > 0;
+
+	if (!bHasDiskBudget && !bHasMemoryBudget)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FilterOverBudget was given no budget, returning every asset"));
+	}
+
+	// An unmeasured closure may be over the memory budget whatever its partial sum, so it is kept and left to the caller
+	Results.RemoveAll([bHasDiskBudget, bHasMemoryBudget, MaxDiskSize, MaxMemorySize](const FAssetInvestigatorSizeResult& Result) {
+		if (!Result.bFound)
+		{
+			return true;
+		}
+
+		const bool bIsOverDisk = bHasDiskBudget && Result.DiskSize > MaxDiskSize;
+		const bool bIsOverMemory = bHasMemoryBudget && (!Result.bHasKnownMemorySize || Result.MemorySize > MaxMemorySize);
+		return (bHasDiskBudget || bHasMemoryBudget) && !bIsOverDisk && !bIsOverMemory;
+		});
+
+	// Rank by whichever budget was given, memory first like the window does, with unmeasured closures after the measured ones
+	const bool bRankByMemory = bHasMemoryBudget;
+	Results.Sort([bRankByMemory](const FAssetInvestigatorSizeResult& Result1, const FAssetInvestigatorSizeResult& Result2) {
+		if (bRankByMemory && Result1.bHasKnownMemorySize != Result2.bHasKnownMemorySize)
+		{
+			return Result1.bHasKnownMemorySize;
+		}
+		return bRankByMemory ? Result1.MemorySize > Result2.MemorySize : Result1.DiskSize > Result2.DiskSize;
+		});
+
+	return Results;
+}
+
+const FAssetDependencyGraph& UAssetInvestigatorSubsystem::GetGraph()
+{
+	if (bIsGraphStale)
+	{
+		if (FAssetRegistryModule::GetRegistry().IsLoadingAssets())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("The asset registry is still scanning, results only cover the assets found so far"));
+		}
+
+		AssetInvestigatorUtility::BuildEditorDependencyGraph(RegistryGraph);
+		bIsGraphStale = false;
+	}
+
+	return RegistryGraph;
+}
+
+void UAssetInvestigatorSubsystem::MeasureClosures(TArrayView<const int32> Nodes, TArrayView<int32> ClosureBuffer, TArrayView<uint32> VisitedBits)
+{
+	for (const int32 Node : Nodes)
+	{
+		if (Node == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const int32 ClosureSize = RegistryGraph.GatherHardClosure(Node, ClosureBuffer, VisitedBits);
+
+		for (int32 i = 0; i < ClosureSize; i++)
+		{
+			const int32 ClosureNode = ClosureBuffer[i];
+			if (RegistryGraph.GetMemorySize(ClosureNode) == FAssetDependencyGraph::UnknownSize)
+			{
+				RegistryGraph.SetMemorySize(ClosureNode, AssetInvestigatorUtility::GetPackageMemorySize(RegistryGraph.GetPackageName(ClosureNode), PackageAssets));
+			}
+		}
+	}
+}
+
+void UAssetInvestigatorSubsystem::OnAssetChanged(const FAssetData& AssetData)
+{
+	bIsGraphStale = true;
+}
+
+void UAssetInvestigatorSubsystem::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	bIsGraphStale = true;
+}
+
+void UAssetInvestigatorSubsystem::ResolveNodes(const FAssetDependencyGraph& Graph, const TArray<FName>& Assets, TArray<int32>& OutNodes)
+{
+	OutNodes.Reset(Assets.Num());
+
+	for (const FName& Asset : Assets)
+	{
+		int32 Node = Graph.FindNode(Asset);
+
+		if (Node == INDEX_NONE)
+		{
+			const FString AssetString = Asset.ToString();
+			if (AssetString.Contains(TEXT(".")))
+			{
+				Node = Graph.FindNode(FName(*FPackageName::ObjectPathToPackageName(AssetString)));
+			}
+		}
+
+		OutNodes.Add(Node);
+	}
+}
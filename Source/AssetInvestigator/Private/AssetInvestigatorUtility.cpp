@@ -2,12 +2,23 @@
 
 #include "AssetInvestigatorUtility.h"
 #include "AssetInfo.h"
+#include "AssetDependencyGraph.h"
+#include "AssetDependencyAnalysis.h"
+#include "AssetDuplicateFinder.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/AssetRegistryState.h"
+
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "GameMapsSettings.h"
+#include "Settings/ProjectPackagingSettings.h"
 
 #include "ContentBrowserModule.h"
 #include "IContentBrowserSingleton.h"
 
 #include "Misc/ScopedSlowTask.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
 #include <string>
 
 #include "K2Node_DynamicCast.h"
@@ -44,7 +55,7 @@ void AssetInvestigatorUtility::BrowseToAsset(const FName& AssetPath)
 	}
 }
 
-void AssetInvestigatorUtility::ExportListToTxt(const TArray<FAssetInfo>& AssetInfoList)
+void AssetInvestigatorUtility::ExportListToTxt(const FAssetInfoTable& AssetInfoList, const FString& FilePath, const TArray<FAssetDuplicateGroup>* DuplicateGroups)
 {
 	if (AssetInfoList.Num() == 0)
 	{
@@ -52,35 +63,98 @@ void AssetInvestigatorUtility::ExportListToTxt(const TArray<FAssetInfo>& AssetIn
 		return;
 	}
 
-	const FString FilePath = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()) + TEXT("AssetInvestigatorReport.txt");
+	const FString ReportPath = FilePath.IsEmpty() ? FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()) + TEXT("AssetInvestigatorReport.txt") : FilePath;
 
 	// Create a file handle
 	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-	IFileHandle* FileHandle = PlatformFile.OpenWrite(*FilePath);
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(ReportPath));
+	IFileHandle* FileHandle = PlatformFile.OpenWrite(*ReportPath);
 
 	if (FileHandle)
 	{
+		const bool bHasDuplicates = DuplicateGroups && DuplicateGroups->Num() > 0;
+
 		// Iterate through the FString array and write each string to the file
-		for (const FAssetInfo& SingleAssetData : AssetInfoList)
+		for (int32 i = 0; i < AssetInfoList.Num(); i++)
 		{
+			const int32 Row = AssetInfoList.GetSortedRow(i);
+			const FAssetSizeInfo AssetSizeInfo = AssetInfoList.GetSizeInfo(Row);
+
 			// Convert FString to ANSI string and write to the file
-			const std::string FilePathAnsi(TCHAR_TO_ANSI(*SingleAssetData.AssetPath.ToString()));
-			const std::string SizeAnsi(TCHAR_TO_ANSI(*MakeBestSizeString(SingleAssetData.AssetSizeInfo.MemorySize, true)));
+			const std::string FilePathAnsi(TCHAR_TO_ANSI(AssetInfoList.GetAssetPath(Row)));
+			const std::string SizeAnsi(TCHAR_TO_ANSI(*MakeBestSizeString(AssetSizeInfo.MemorySize, AssetSizeInfo.bHasKnownMemorySize)));
+			const std::string DiskSizeAnsi(TCHAR_TO_ANSI(*MakeBestSizeString(AssetSizeInfo.DiskSize, true)));
 
 			FileHandle->Write((const uint8*)FilePathAnsi.c_str(), FilePathAnsi.length());
 			FileHandle->Write((const uint8*)"=> ", 3);  
 			FileHandle->Write((const uint8*)SizeAnsi.c_str(), SizeAnsi.length());
+			FileHandle->Write((const uint8*)", disk ", 7);
+			FileHandle->Write((const uint8*)DiskSizeAnsi.c_str(), DiskSizeAnsi.length());
+
+			if (bHasDuplicates)
+			{
+				const std::string DuplicateSizeAnsi(TCHAR_TO_ANSI(*MakeBestSizeString(AssetInfoList.GetDuplicateSize(Row), true)));
+
+				FileHandle->Write((const uint8*)", duplicates ", 13);
+				FileHandle->Write((const uint8*)DuplicateSizeAnsi.c_str(), DuplicateSizeAnsi.length());
+			}
+
 			FileHandle->Write((const uint8*)"\n", 1);  // Add a newline after each string
 		}
 
+		if (bHasDuplicates)
+		{
+			FileHandle->Write((const uint8*)"\nDuplicate groups\n", 18);
+
+			for (const FAssetDuplicateGroup& Group : *DuplicateGroups)
+			{
+				const std::string GroupAnsi(TCHAR_TO_ANSI(*FString::Printf(TEXT("%s, %d copies, wasted %s, package %s\n"), *Group.ClassName.ToString(), Group.PackageNames.Num(),
+					*MakeBestSizeString(Group.WastedSize, true), *MakeBestSizeString(Group.PackageSize, true))));
+				FileHandle->Write((const uint8*)GroupAnsi.c_str(), GroupAnsi.length());
+
+				for (const FName& PackageName : Group.PackageNames)
+				{
+					const std::string PackageAnsi(TCHAR_TO_ANSI(*FString::Printf(TEXT("\t%s\n"), *PackageName.ToString())));
+					FileHandle->Write((const uint8*)PackageAnsi.c_str(), PackageAnsi.length());
+				}
+			}
+		}
+
 		// Close the file handle
 		delete FileHandle;
 	}
 	else
 	{
 		// Handle the case where the file couldn't be created
-		UE_LOG(LogTemp, Error, TEXT("Failed to create file for exporting FString array: %s"), *FilePath);
+		UE_LOG(LogTemp, Error, TEXT("Failed to create file for exporting FString array: %s"), *ReportPath);
+	}
+}
+
+void AssetInvestigatorUtility::BuildEditorDependencyGraph(FAssetDependencyGraph& OutGraph)
+{
+	// The live state, the same one the Asset Manager's Editor registry source points at, read in place instead of copied
+	OutGraph.Build(*FAssetRegistryModule::GetRegistry().GetAssetRegistryState());
+}
+
+int64 AssetInvestigatorUtility::GetPackageMemorySize(const FName& PackageName, TArray<FAssetData>& ScratchAssets)
+{
+	int64 MemorySize = 0;
+
+	ScratchAssets.Reset();
+	IAssetRegistry::Get()->GetAssetsByPackageName(PackageName, ScratchAssets);
+
+	for (const FAssetData& AssetData : ScratchAssets)
+	{
+		// Resource size can currently only be calculated for loaded assets, so load and check
+		UObject* Asset = AssetData.GetAsset();
+
+		if (Asset)
+		{
+			MemorySize += Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
 	}
+
+	return MemorySize;
 }
 
 FString AssetInvestigatorUtility::MakeBestSizeString(const SIZE_T SizeInBytes, const bool bHasKnownSize)
@@ -150,3 +224,240 @@ TArray<UEdGraphNode*> AssetInvestigatorUtility::GetDynamicCastToNodes(const FNam
 
 	return FoundNodes;
 }
+
+TArray<UEdGraphNode*> AssetInvestigatorUtility::GetCyclicCastToNodes(const TArray<FName>& PackageNames)
+{
+	TArray<UEdGraphNode*> FoundNodes;
+
+	const TSet<FName> CyclePackages(PackageNames);
+
+	for (const FName& PackageName : PackageNames)
+	{
+		TArray<FAssetData> PackageAssets;
+		IAssetRegistry::Get()->GetAssetsByPackageName(PackageName, PackageAssets);
+
+		for (const FAssetData& AssetData : PackageAssets)
+		{
+			UBlueprint* Blueprint = Cast<UBlueprint>(AssetData.GetAsset());
+			if (!Blueprint)
+			{
+				continue;
+			}
+
+			TArray<UEdGraph*> Graphs;
+			Blueprint->GetAllGraphs(Graphs);
+
+			for (UEdGraph* Graph : Graphs)
+			{
+				for (UEdGraphNode* Node : Graph->Nodes)
+				{
+					// Only casts into another member of the cycle close the loop
+					const UK2Node_DynamicCast* CastNode = Cast<UK2Node_DynamicCast>(Node);
+					if (CastNode && CastNode->TargetType && CastNode->TargetType->GetOutermost() != Blueprint->GetOutermost()
+						&& CyclePackages.Contains(CastNode->TargetType->GetOutermost()->GetFName()))
+					{
+						FoundNodes.Add(Node);
+					}
+				}
+			}
+		}
+	}
+
+	return FoundNodes;
+}
+
+void AssetInvestigatorUtility::ExportCyclesToTxt(const TArray<FAssetDependencyCycle>& Cycles, const FAssetDependencyGraph& Graph, const FString& FilePath)
+{
+	if (Cycles.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The empty cycle list can not be exported"));
+		return;
+	}
+
+	const FString ReportPath = FilePath.IsEmpty() ? FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()) + TEXT("AssetInvestigatorCycles.txt") : FilePath;
+
+	int32 NumPackages = 0;
+	for (const FAssetDependencyCycle& Cycle : Cycles)
+	{
+		NumPackages += Cycle.Nodes.Num();
+	}
+
+	// Finding the casts loads every Blueprint of every cycle, progress is counted in packages
+	FScopedSlowTask SlowTask(NumPackages, LOCTEXT("ExportingCycles", "Loading the Blueprints of reference cycles..."));
+	SlowTask.MakeDialogDelayed(.1f, true);
+
+	TArray<FString> Lines;
+	TArray<FName> PackageNames;
+	int32 CancelledCycleIndex = INDEX_NONE;
+	for (int32 CycleIndex = 0; CycleIndex < Cycles.Num(); CycleIndex++)
+	{
+		const FAssetDependencyCycle& Cycle = Cycles[CycleIndex];
+
+		SlowTask.EnterProgressFrame(Cycle.Nodes.Num());
+		if (CancelledCycleIndex == INDEX_NONE && SlowTask.ShouldCancel())
+		{
+			CancelledCycleIndex = CycleIndex;
+		}
+
+		Lines.Add(FString::Printf(TEXT("Cycle %d: %d packages => %s, disk %s"), CycleIndex, Cycle.Nodes.Num(),
+			*MakeBestSizeString(Cycle.CombinedSize.MemorySize, Cycle.CombinedSize.bHasKnownMemorySize), *MakeBestSizeString(Cycle.CombinedSize.DiskSize, true)));
+
+		for (const int32 NodeIndex : Cycle.Nodes)
+		{
+			Lines.Add(TEXT("\t") + Graph.GetPackageName(NodeIndex).ToString());
+		}
+
+		for (const TPair<int32, int32>& Edge : Cycle.Edges)
+		{
+			Lines.Add(FString::Printf(TEXT("\t%s -> %s"), *Graph.GetPackageName(Edge.Key).ToString(), *Graph.GetPackageName(Edge.Value).ToString()));
+		}
+
+		// The casts are what has to change to break the cycle, once cancelled the rest of the cycles are written without them
+		if (CancelledCycleIndex != INDEX_NONE)
+		{
+			continue;
+		}
+
+		PackageNames.Reset();
+		for (const int32 NodeIndex : Cycle.Nodes)
+		{
+			PackageNames.Add(Graph.GetPackageName(NodeIndex));
+		}
+
+		for (const UEdGraphNode* CastNode : GetCyclicCastToNodes(PackageNames))
+		{
+			Lines.Add(FString::Printf(TEXT("\tCastTo in %s, graph %s: %s"), *CastNode->GetOutermost()->GetName(), *CastNode->GetGraph()->GetName(),
+				*CastNode->GetNodeTitle(ENodeTitleType::ListView).ToString()));
+		}
+	}
+
+	if (CancelledCycleIndex != INDEX_NONE)
+	{
+		Lines.Insert(FString::Printf(TEXT("Cancelled, CastTo nodes are only listed for the first %d cycles"), CancelledCycleIndex), 0);
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *ReportPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to create file for exporting cycles: %s"), *ReportPath);
+	}
+}
+
+void AssetInvestigatorUtility::GatherCookRoots(const FAssetDependencyGraph& Graph, TArray<int32>& OutRoots)
+{
+	OutRoots.Reset();
+
+	TSet<FName> RootPackages;
+
+	auto AddObjectPath = [&RootPackages](const FString& ObjectPath)
+	{
+		if (!ObjectPath.IsEmpty())
+		{
+			RootPackages.Add(FName(*FPackageName::ObjectPathToPackageName(ObjectPath)));
+		}
+	};
+
+	const UProjectPackagingSettings* PackagingSettings = GetDefault<UProjectPackagingSettings>();
+
+	for (const FFilePath& MapToCook : PackagingSettings->MapsToCook)
+	{
+		AddObjectPath(MapToCook.FilePath);
+	}
+
+	// The cook takes every map it can find when none are listed
+	if (PackagingSettings->MapsToCook.Num() == 0)
+	{
+		FARFilter Filter;
+		Filter.bRecursivePaths = true;
+		Filter.ClassNames.Add(UWorld::StaticClass()->GetFName());
+		Filter.PackagePaths.Add("/Game");
+
+		TArray<FAssetData> FoundMaps;
+		IAssetRegistry::Get()->GetAssets(Filter, FoundMaps);
+
+		for (const FAssetData& Map : FoundMaps)
+		{
+			RootPackages.Add(Map.PackageName);
+		}
+	}
+
+	AddObjectPath(UGameMapsSettings::GetGameDefaultMap());
+	AddObjectPath(UGameMapsSettings::GetGlobalDefaultGameMode());
+	AddObjectPath(GetDefault<UGameMapsSettings>()->GameInstanceClass.ToString());
+
+	if (UAssetManager::IsValid())
+	{
+		UAssetManager& AssetManager = UAssetManager::Get();
+
+		TArray<FPrimaryAssetTypeInfo> TypeInfos;
+		AssetManager.GetPrimaryAssetTypeInfoList(TypeInfos);
+
+		TArray<FPrimaryAssetId> PrimaryAssetIds;
+		for (const FPrimaryAssetTypeInfo& TypeInfo : TypeInfos)
+		{
+			PrimaryAssetIds.Reset();
+			AssetManager.GetPrimaryAssetIdList(TypeInfo.PrimaryAssetType, PrimaryAssetIds);
+
+			for (const FPrimaryAssetId& PrimaryAssetId : PrimaryAssetIds)
+			{
+				// As in UAssetManager::ModifyCook, the other rules only cook a primary asset that something references
+				const EPrimaryAssetCookRule CookRule = AssetManager.GetPrimaryAssetRules(PrimaryAssetId).CookRule;
+				if (CookRule == EPrimaryAssetCookRule::AlwaysCook || CookRule == EPrimaryAssetCookRule::DevelopmentAlwaysCook)
+				{
+					AddObjectPath(AssetManager.GetPrimaryAssetPath(PrimaryAssetId).ToString());
+				}
+			}
+		}
+	}
+
+	for (const FName& PackageName : RootPackages)
+	{
+		const int32 NodeIndex = Graph.FindNode(PackageName);
+		if (NodeIndex != INDEX_NONE)
+		{
+			OutRoots.Add(NodeIndex);
+		}
+	}
+
+	if (PackagingSettings->DirectoriesToAlwaysCook.Num() > 0)
+	{
+		TArray<FString> AlwaysCookPaths;
+		for (const FDirectoryPath& Directory : PackagingSettings->DirectoriesToAlwaysCook)
+		{
+			AlwaysCookPaths.Add(Directory.Path / TEXT(""));
+		}
+
+		for (int32 NodeIndex = 0; NodeIndex < Graph.Num(); NodeIndex++)
+		{
+			const FString PackageName = Graph.GetPackageName(NodeIndex).ToString();
+
+			if (AlwaysCookPaths.ContainsByPredicate([&PackageName](const FString& Path) { return PackageName.StartsWith(Path); }))
+			{
+				OutRoots.Add(NodeIndex);
+			}
+		}
+	}
+}
+
+void AssetInvestigatorUtility::ExportUnreferencedToTxt(const TArray<int32>& Nodes, const FAssetDependencyGraph& Graph, const FString& FilePath)
+{
+	if (Nodes.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The empty unreferenced list can not be exported"));
+		return;
+	}
+
+	const FString ReportPath = FilePath.IsEmpty() ? FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()) + TEXT("AssetInvestigatorUnreferenced.txt") : FilePath;
+
+	TArray<FString> Lines;
+	Lines.Reserve(Nodes.Num());
+
+	for (const int32 NodeIndex : Nodes)
+	{
+		Lines.Add(FString::Printf(TEXT("%s=> disk %s"), *Graph.GetPackageName(NodeIndex).ToString(), *MakeBestSizeString(Graph.GetDiskSize(NodeIndex), true)));
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *ReportPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to create file for exporting unreferenced packages: %s"), *ReportPath);
+	}
+}
@@ -0,0 +1,237 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CookedAssetRegistry.h"
+#include "AssetRegistry/AssetRegistryState.h"
+#include "AssetData.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/App.h"
+
+namespace CookedAssetRegistryPrivate
+{
+	static const FName BlueprintClassName(TEXT("Blueprint"));
+	static const FName BlueprintGeneratedClassName(TEXT("BlueprintGeneratedClass"));
+
+	/** Parses a line of UnrealPak -List output: LogPakFile: Display: "Game/Content/A.uasset" offset: 0, size: 1234 bytes, ... */
+	bool ParsePakListLine(const FString& Line, FString& OutFilename, int64& OutSize)
+	{
+		int32 FirstQuote = INDEX_NONE;
+		if (!Line.FindChar(TEXT('"'), FirstQuote))
+		{
+			return false;
+		}
+
+		const int32 SecondQuote = Line.Find(TEXT("\""), ESearchCase::CaseSensitive, ESearchDir::FromStart, FirstQuote + 1);
+		if (SecondQuote == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const int32 SizeStart = Line.Find(TEXT("size: "), ESearchCase::IgnoreCase, ESearchDir::FromStart, SecondQuote);
+		if (SizeStart == INDEX_NONE)
+		{
+			return false;
+		}
+
+		OutFilename = Line.Mid(FirstQuote + 1, SecondQuote - FirstQuote - 1);
+		OutSize = FCString::Atoi64(*Line + SizeStart + 6);
+		return true;
+	}
+}
+
+FCookedAssetRegistry::FCookedAssetRegistry()
+	: State(MakeUnique<FAssetRegistryState>())
+{
+}
+
+FCookedAssetRegistry::~FCookedAssetRegistry() = default;
+
+FString FCookedAssetRegistry::GetDevelopmentRegistryPath(const FString& PlatformName)
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Cooked"), PlatformName, FApp::GetProjectName(), TEXT("Metadata"), TEXT("DevelopmentAssetRegistry.bin"));
+}
+
+bool FCookedAssetRegistry::LoadDevelopmentRegistry(const FString& RegistryPath)
+{
+	State = MakeUnique<FAssetRegistryState>();
+	ListedPackageSizes.Reset();
+	bIsLoaded = false;
+
+	// Stream through a buffered file reader instead of FAssetRegistryState::LoadFromDisk, which reads the whole file into memory first.
+	// The file is not memory mapped, the reader only keeps its small read buffer and the parsed state in memory
+	TUniquePtr<FArchive> FileReader(IFileManager::Get().CreateFileReader(*RegistryPath));
+	if (!FileReader)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to open cooked asset registry: %s"), *RegistryPath);
+		return false;
+	}
+
+	FAssetRegistryLoadOptions LoadOptions;
+	LoadOptions.bLoadDependencies = true;
+	LoadOptions.bLoadPackageData = true;
+
+	bIsLoaded = State->Load(*FileReader, LoadOptions) && !FileReader->IsError();
+
+	if (bIsLoaded)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Loaded cooked asset registry %s with %d packages"), *RegistryPath, State->GetAssetPackageDataMap().Num());
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to read cooked asset registry: %s"), *RegistryPath);
+		State = MakeUnique<FAssetRegistryState>();
+	}
+
+	return bIsLoaded;
+}
+
+bool FCookedAssetRegistry::LoadPackageListing(const FString& ListingPath)
+{
+	ListedPackageSizes.Reset();
+
+	// IoStore listings are CSV with a header row, pak listings are UnrealPak log lines
+	int32 PackageNameColumn = INDEX_NONE;
+	int32 FilenameColumn = INDEX_NONE;
+	int32 SizeColumn = INDEX_NONE;
+	bool bIsCsv = false;
+	bool bIsFirstLine = true;
+
+	// Lines are visited one at a time and copied into one reused buffer, so a listing of a million files is never held as strings
+	FString Line;
+	TArray<FString> Columns;
+	FString Filename;
+	FString PackageName;
+
+	auto VisitLine = [&](FStringView LineView)
+	{
+		Line.Reset();
+		Line.Append(LineView.GetData(), LineView.Len());
+
+		if (bIsFirstLine)
+		{
+			bIsFirstLine = false;
+
+			if (!Line.Contains(TEXT("\"")))
+			{
+				Line.ParseIntoArray(Columns, TEXT(","), false);
+
+				for (int32 i = 0; i < Columns.Num(); i++)
+				{
+					const FString Column = Columns[i].TrimStartAndEnd();
+					if (Column == TEXT("PackageName"))
+					{
+						PackageNameColumn = i;
+					}
+					else if (Column == TEXT("Filename"))
+					{
+						FilenameColumn = i;
+					}
+					else if (Column == TEXT("CompressedSize") || (Column == TEXT("Size") && SizeColumn == INDEX_NONE))
+					{
+						SizeColumn = i;
+					}
+				}
+			}
+
+			bIsCsv = SizeColumn != INDEX_NONE && (PackageNameColumn != INDEX_NONE || FilenameColumn != INDEX_NONE);
+			if (bIsCsv)
+			{
+				return;
+			}
+		}
+
+		int64 Size = 0;
+		PackageName.Reset();
+
+		if (bIsCsv)
+		{
+			Line.ParseIntoArray(Columns, TEXT(","), false);
+			if (!Columns.IsValidIndex(SizeColumn))
+			{
+				return;
+			}
+
+			Size = FCString::Atoi64(*Columns[SizeColumn].TrimStartAndEnd());
+
+			if (Columns.IsValidIndex(PackageNameColumn) && Columns[PackageNameColumn].TrimStartAndEnd().StartsWith(TEXT("/")))
+			{
+				PackageName = Columns[PackageNameColumn].TrimStartAndEnd();
+			}
+			else if (!Columns.IsValidIndex(FilenameColumn) || !TryConvertCookedFilenameToPackageName(Columns[FilenameColumn].TrimStartAndEnd(), PackageName))
+			{
+				return;
+			}
+		}
+		else if (!CookedAssetRegistryPrivate::ParsePakListLine(Line, Filename, Size) || !TryConvertCookedFilenameToPackageName(Filename, PackageName))
+		{
+			return;
+		}
+
+		ListedPackageSizes.FindOrAdd(FName(*PackageName)) += Size;
+	};
+
+	if (!FFileHelper::LoadFileToStringWithLineVisitor(*ListingPath, VisitLine))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to open package listing: %s"), *ListingPath);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Read sizes of %d packages from %s"), ListedPackageSizes.Num(), *ListingPath);
+
+	return ListedPackageSizes.Num() > 0;
+}
+
+void FCookedAssetRegistry::GatherRootAssets(TArray<const FAssetData*>& OutAssets) const
+{
+	OutAssets.Reset();
+
+	for (const auto& Pair : State->GetObjectPathToAssetDataMap())
+	{
+		const FAssetData* AssetData = Pair.Value;
+
+		if ((AssetData->AssetClass == CookedAssetRegistryPrivate::BlueprintClassName || AssetData->AssetClass == CookedAssetRegistryPrivate::BlueprintGeneratedClassName)
+			&& AssetData->PackageName.ToString().StartsWith(TEXT("/Game/")))
+		{
+			OutAssets.Add(AssetData);
+		}
+	}
+}
+
+bool FCookedAssetRegistry::TryConvertCookedFilenameToPackageName(const FString& CookedFilename, FString& OutPackageName)
+{
+	FString Filename = CookedFilename.Replace(TEXT("\\"), TEXT("/"));
+
+	const FString Extension = FPaths::GetExtension(Filename);
+	if (Extension != TEXT("uasset") && Extension != TEXT("umap") && Extension != TEXT("uexp") && Extension != TEXT("ubulk") && Extension != TEXT("uptnl"))
+	{
+		return false;
+	}
+
+	while (Filename.RemoveFromStart(TEXT("../")))
+	{
+	}
+
+	const int32 ContentIndex = Filename.Find(TEXT("/Content/"));
+	if (ContentIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// The folder right above Content names the mount point: Engine, a plugin, or the project itself
+	const FString MountFolder = Filename.Left(ContentIndex);
+	FString MountPoint = TEXT("/Game/");
+
+	if (MountFolder == TEXT("Engine") || MountFolder.EndsWith(TEXT("/Engine")))
+	{
+		MountPoint = TEXT("/Engine/");
+	}
+	else if (MountFolder.Contains(TEXT("/Plugins/")))
+	{
+		MountPoint = TEXT("/") + FPaths::GetCleanFilename(MountFolder) + TEXT("/");
+	}
+
+	OutPackageName = MountPoint + FPaths::GetBaseFilename(Filename.Mid(ContentIndex + 9), false);
+	return true;
+}
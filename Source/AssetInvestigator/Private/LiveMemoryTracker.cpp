@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LiveMemoryTracker.h"
+#include "AssetDependencyGraph.h"
+#include "AssetInfo.h"
+
+#include "UObject/UObjectArray.h"
+#include "UObject/Package.h"
+#include "UObject/GarbageCollection.h"
+
+FLiveMemoryTracker::~FLiveMemoryTracker()
+{
+	Stop();
+}
+
+void FLiveMemoryTracker::Start()
+{
+	if (IsRunning())
+	{
+		return;
+	}
+
+	NextObjectIndex = 0;
+	PendingPackageSizes.Reset();
+
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FLiveMemoryTracker::Tick), TickInterval);
+}
+
+void FLiveMemoryTracker::Stop()
+{
+	// Without ticks a comparison in progress would never finish
+	ComparedGraph = nullptr;
+	ComparedRoots = nullptr;
+
+	if (IsRunning())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+}
+
+float FLiveMemoryTracker::GetSweepProgress() const
+{
+	const int32 NumObjects = GUObjectArray.GetObjectArrayNum();
+	return NumObjects > 0 ? FMath::Min(1.f, (float)NextObjectIndex / NumObjects) : 0.f;
+}
+
+bool FLiveMemoryTracker::Tick(float DeltaTime)
+{
+	const double EndTime = FPlatformTime::Seconds() + TickBudgetSeconds;
+
+	// A comparison only reads the graph and the published sweep, it takes the whole budget until it is done
+	if (IsComparing())
+	{
+		AdvanceComparison(EndTime);
+		return true;
+	}
+
+	// Objects are being destroyed or half constructed, try again next tick
+	if (IsGarbageCollecting() || IsLoading())
+	{
+		return true;
+	}
+	const int32 NumObjects = GUObjectArray.GetObjectArrayNum();
+
+	while (NextObjectIndex < NumObjects)
+	{
+		const int32 BatchEnd = FMath::Min(NextObjectIndex + ObjectsPerBudgetCheck, NumObjects);
+
+		for (; NextObjectIndex < BatchEnd; ++NextObjectIndex)
+		{
+			FUObjectItem* ObjectItem = GUObjectArray.IndexToObject(NextObjectIndex);
+			if (!ObjectItem || !ObjectItem->Object || ObjectItem->IsUnreachable() || ObjectItem->IsPendingKill())
+			{
+				continue;
+			}
+
+			UObject* Object = static_cast<UObject*>(ObjectItem->Object);
+			if (Object->IsA<UPackage>() || Object->HasAnyFlags(RF_ClassDefaultObject | RF_NeedLoad | RF_NeedPostLoad))
+			{
+				continue;
+			}
+
+			PendingPackageSizes.FindOrAdd(Object->GetOutermost()->GetFName()) += Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		}
+
+		if (FPlatformTime::Seconds() > EndTime)
+		{
+			return true;
+		}
+	}
+
+	// Sweep done, publish it and start over on the next tick
+	Swap(ResidentPackageSizes, PendingPackageSizes);
+	PendingPackageSizes.Reset();
+	NextObjectIndex = 0;
+	++CompletedSweeps;
+
+	return true;
+}
+
+void FLiveMemoryTracker::StartComparison(const FAssetDependencyGraph& Graph, const FAssetInfoTable& Roots)
+{
+	if (CompletedSweeps == 0)
+	{
+		return;
+	}
+
+	ComparedGraph = &Graph;
+	ComparedRoots = &Roots;
+	NextComparedRow = 0;
+	ComparingSweep = CompletedSweeps;
+	PendingComparison = FLiveMemoryComparison();
+
+	// One name lookup per resident package, the closure walks below then only index arrays
+	ResidentNodeSizes.Init(INDEX_NONE, Graph.Num());
+	for (const TPair<FName, int64>& Pair : ResidentPackageSizes)
+	{
+		const int32 NodeIndex = Graph.FindNode(Pair.Key);
+		if (NodeIndex != INDEX_NONE)
+		{
+			ResidentNodeSizes[NodeIndex] = Pair.Value;
+		}
+	}
+
+	NeededNodes.Init(false, Graph.Num());
+	ClosureBuffer.SetNumUninitialized(Graph.Num(), false);
+	VisitedBits.SetNumZeroed((Graph.Num() + 31) / 32, false);
+}
+
+void FLiveMemoryTracker::ResetComparison()
+{
+	ComparedGraph = nullptr;
+	ComparedRoots = nullptr;
+	Comparison = FLiveMemoryComparison();
+	ComparedSweep = INDEX_NONE;
+}
+
+void FLiveMemoryTracker::AdvanceComparison(const double EndTime)
+{
+	const FAssetDependencyGraph& Graph = *ComparedGraph;
+	const FAssetInfoTable& Roots = *ComparedRoots;
+
+	while (NextComparedRow < Roots.Num())
+	{
+		const int32 Row = NextComparedRow++;
+		const int32 RootNode = Roots.GetPackageNode(Row);
+		if (ResidentNodeSizes[RootNode] == INDEX_NONE)
+		{
+			continue;
+		}
+
+		FLiveMemoryComparison::FLoadedRoot& LoadedRoot = PendingComparison.LoadedRoots.AddDefaulted_GetRef();
+		LoadedRoot.Row = Row;
+		LoadedRoot.PredictedMemorySize = Roots.GetSizeInfo(Row).MemorySize;
+
+		const int32 NumClosureNodes = Graph.GatherHardClosure(RootNode, ClosureBuffer, VisitedBits);
+		for (int32 i = 0; i < NumClosureNodes; ++i)
+		{
+			const int32 NodeIndex = ClosureBuffer[i];
+			NeededNodes[NodeIndex] = true;
+
+			if (ResidentNodeSizes[NodeIndex] != INDEX_NONE)
+			{
+				LoadedRoot.ResidentMemorySize += ResidentNodeSizes[NodeIndex];
+			}
+		}
+
+		if (FPlatformTime::Seconds() > EndTime)
+		{
+			return;
+		}
+	}
+
+	// Only content packages are reported, script and transient packages are always resident and have no node
+	for (int32 NodeIndex = 0; NodeIndex < Graph.Num(); ++NodeIndex)
+	{
+		if (ResidentNodeSizes[NodeIndex] != INDEX_NONE && !NeededNodes[NodeIndex])
+		{
+			FLiveMemoryComparison::FUnclaimedPackage& UnclaimedPackage = PendingComparison.UnclaimedPackages.AddDefaulted_GetRef();
+			UnclaimedPackage.Node = NodeIndex;
+			UnclaimedPackage.ResidentMemorySize = ResidentNodeSizes[NodeIndex];
+
+			PendingComparison.UnclaimedMemorySize += ResidentNodeSizes[NodeIndex];
+		}
+	}
+
+	PendingComparison.UnclaimedPackages.Sort([](const FLiveMemoryComparison::FUnclaimedPackage& Package1, const FLiveMemoryComparison::FUnclaimedPackage& Package2) {
+		return Package1.ResidentMemorySize > Package2.ResidentMemorySize;
+		});
+
+	Swap(Comparison, PendingComparison);
+	ComparedSweep = ComparingSweep;
+	ComparedGraph = nullptr;
+	ComparedRoots = nullptr;
+}
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+struct FAssetDependencyGraph;
+
+/**
+ * Squarified treemap of one root's closure, clustered by folder. Cluster 0 is the root folder,
+ * the children of cluster C are ChildIndices[C.FirstChild .. C.FirstChild + C.NumChildren).
+ * Rectangles are in layout space, a LayoutWidth x 1 box.
+ */
+struct ASSETINVESTIGATOR_API FAssetTreemapLayout
+{
+	static constexpr float LayoutWidth = 1.6f;
+
+	struct FCluster
+	{
+		FString Label;
+		int64 Size = 0;
+
+		FVector2D Min = FVector2D::ZeroVector;
+		FVector2D Max = FVector2D::ZeroVector;
+
+		/** Graph node for packages, INDEX_NONE for folders */
+		int32 Node = INDEX_NONE;
+
+		int32 Depth = 0;
+		int32 FirstChild = 0;
+		int32 NumChildren = 0;
+
+		/** Fill hue derived from the label, computed with the layout so drawing does not hash strings */
+		float Hue = 0.0f;
+
+		/**
+		 * Bounds, total size and count of this cluster and every smaller sibling after it. Siblings are sorted by size,
+		 * so once one is too small to draw, it and the rest are drawn as this one block.
+		 */
+		FVector2D TailMin = FVector2D::ZeroVector;
+		FVector2D TailMax = FVector2D::ZeroVector;
+		int64 TailSize = 0;
+		int32 TailCount = 0;
+	};
+
+	TArray<FCluster> Clusters;
+	TArray<int32> ChildIndices;
+};
+
+/**
+ * In-plugin replacement for the size map on closures too large for it. Layouts are computed on a worker thread
+ * from a snapshot of the closure and cached per root; drawing walks the folder hierarchy and stops at clusters
+ * that are off screen or too small to tell apart, so only what is visible costs anything.
+ */
+class ASSETINVESTIGATOR_API FAssetClosureTreemap
+{
+public:
+
+	/** Drops every cached and pending layout, call whenever the graph they were computed from changes */
+	void Invalidate();
+
+	/**
+	 * Returns the cached layout of RootNode's closure, or kicks off computing it.
+	 *
+	 * @param Graph     The graph to gather the closure from.
+	 * @param RootNode  The root to lay out.
+	 * @param GetSize   The size each package is weighted by.
+	 * @return          The layout, or null while it is being computed.
+	 */
+	TSharedPtr<const FAssetTreemapLayout> RequestLayout(const FAssetDependencyGraph& Graph, const int32 RootNode, TFunctionRef<int64(int32)> GetSize);
+
+	/**
+	 * Draws the layout into an ImGui canvas. Mouse wheel zooms, right drag pans, double click resets the view.
+	 *
+	 * @param Layout  The layout to draw.
+	 * @param Height  The canvas height in pixels, it spans the available width.
+	 * @return        The graph node of the package clicked this frame, or INDEX_NONE.
+	 */
+	int32 Draw(const FAssetTreemapLayout& Layout, const float Height);
+
+	/** Builds a layout, runs on a worker thread */
+	static TSharedPtr<const FAssetTreemapLayout> BuildLayout(const TArray<int32>& Nodes, const TArray<FString>& PackageNames, const TArray<int64>& Sizes);
+
+private:
+
+	/** Clusters smaller than this on screen are drawn as one block instead of descending into them */
+	static constexpr float MinClusterPixels = 24.0f;
+
+	/** Packages with less screen area than this square are merged into their parent's tail block */
+	static constexpr float MinLeafPixels = 2.0f;
+
+	/** Plenty for switching back and forth between roots */
+	static constexpr int32 MaxCachedLayouts = 16;
+
+	TMap<int32, TSharedPtr<const FAssetTreemapLayout>> CachedLayouts;
+	TArray<int32> CachedRootOrder;
+
+	int32 PendingRootNode = INDEX_NONE;
+	TFuture<TSharedPtr<const FAssetTreemapLayout>> PendingLayout;
+
+	/** Bumped by Invalidate so layouts of an outdated graph are dropped when they finish */
+	int32 Generation = 0;
+	int32 PendingGeneration = 0;
+
+	float Zoom = 1.0f;
+	FVector2D Pan = FVector2D::ZeroVector;
+};
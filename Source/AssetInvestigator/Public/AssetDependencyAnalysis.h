@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetInfo.h"
+
+struct FAssetDependencyGraph;
+
+/**
+ * A hard reference whose removal is part of a cut, together with what removing only this edge would save.
+ */
+struct ASSETINVESTIGATOR_API FAssetDependencyCut
+{
+	int32 FromNode = INDEX_NONE;
+	int32 ToNode = INDEX_NONE;
+
+	FAssetSizeInfo SavedSize;
+};
+
+/**
+ * Answer to "why is Target loaded when Root is": the shortest hard reference chain and a minimal set of edges to break.
+ */
+struct ASSETINVESTIGATOR_API FAssetDependencyExplanation
+{
+	/** Nodes from Root to Target, both included */
+	TArray<int32> Path;
+
+	/** Minimal set of hard references whose removal drops Target from Root's closure */
+	TArray<FAssetDependencyCut> Cuts;
+
+	/** What removing every edge in Cuts at once saves */
+	FAssetSizeInfo TotalSavedSize;
+
+	/** True if Cuts was not computed because more than MaxCutEdges independent chains lead to Target */
+	bool bCutTooLarge = false;
+};
+
+/**
+ * A strongly connected group of packages that all hard reference each other, directly or through the group.
+ */
+struct ASSETINVESTIGATOR_API FAssetDependencyCycle
+{
+	TArray<int32> Nodes;
+
+	/** The hard references between members of the group, From -> To */
+	TArray<TPair<int32, int32>> Edges;
+
+	FAssetSizeInfo CombinedSize;
+};
+
+/**
+ * Graph algorithms over FAssetDependencyGraph. Nothing here recurses, so deep reference chains are safe.
+ */
+class ASSETINVESTIGATOR_API AssetDependencyAnalysis
+{
+public:
+
+	/** Beyond this many edge-disjoint chains a cut is not a useful suggestion anymore */
+	static constexpr int32 MaxCutEdges = 32;
+
+	/**
+	 * Finds the shortest hard reference chain from Root to Target with a breadth first search.
+	 *
+	 * @param Graph    The graph to search.
+	 * @param Root     The node the chain starts at.
+	 * @param Target   The node the chain ends at.
+	 * @param OutPath  Receives the nodes of the chain, Root first and Target last.
+	 * @return         False if Target is not in Root's hard closure.
+	 */
+	static bool FindHardPath(const FAssetDependencyGraph& Graph, const int32 Root, const int32 Target, TArray<int32>& OutPath);
+
+	/**
+	 * Computes the shortest chain and a minimum edge cut between Root and Target with unit capacity max-flow
+	 * over Root's hard closure, then measures what each cut edge and the whole cut save.
+	 *
+	 * @return False if Target is not in Root's hard closure.
+	 */
+	static bool ExplainHardDependency(const FAssetDependencyGraph& Graph, const int32 Root, const int32 Target, FAssetDependencyExplanation& OutExplanation);
+
+	/**
+	 * Gathers Root's hard closure as if the given edges did not exist.
+	 */
+	static void GatherHardClosureWithout(const FAssetDependencyGraph& Graph, const int32 Root, TArrayView<const FAssetDependencyCut> RemovedEdges, TArray<int32>& OutNodes);
+
+	/**
+	 * Finds every hard reference cycle with Tarjan's strongly connected components algorithm, run with an explicit
+	 * call stack so it is linear in the size of the graph and safe on arbitrarily deep chains.
+	 *
+	 * @param Graph      The graph to search.
+	 * @param OutCycles  Receives every component with more than one package, or a package referencing itself.
+	 */
+	static void FindHardCycles(const FAssetDependencyGraph& Graph, TArray<FAssetDependencyCycle>& OutCycles);
+
+	/**
+	 * Marks everything reachable from any of the roots over hard and soft references in one multi-source
+	 * breadth first search, linear in the size of the graph.
+	 *
+	 * @param Graph           The graph to search.
+	 * @param Roots           The nodes that are kept regardless of references, e.g. maps and primary assets.
+	 * @param OutUnreachable  Receives every node no root reaches, largest on disk first.
+	 */
+	static void FindUnreachable(const FAssetDependencyGraph& Graph, TArrayView<const int32> Roots, TArray<int32>& OutUnreachable);
+
+	/**
+	 * Measures what each root alone pulls in: the part of its hard closure no other root of the set reaches.
+	 * Walks every closure once, so the cost is the sum of the closure sizes.
+	 *
+	 * @param Graph             The graph to search.
+	 * @param Roots             The roots to compare against each other, duplicates count as one root.
+	 * @param OutExclusiveSizes Receives one size per entry of Roots, in the same order.
+	 */
+	static void GatherExclusiveSizes(const FAssetDependencyGraph& Graph, TArrayView<const int32> Roots, TArray<FAssetSizeInfo>& OutExclusiveSizes);
+
+	/**
+	 * Finds the packages nothing outside their own cycle hard references that pull each target in, walking reverse hard references.
+	 * The reverse adjacency and the strongly connected components are built once for the whole batch.
+	 *
+	 * @param Graph       The graph to search.
+	 * @param Targets     The packages to find the roots of.
+	 * @param OutRoots    Receives one array of root nodes per entry of Targets, a target nothing references is its own root.
+	 *                    A cycle nothing else references reports all its packages as roots.
+	 */
+	static void FindReverseRoots(const FAssetDependencyGraph& Graph, TArrayView<const int32> Targets, TArray<TArray<int32>>& OutRoots);
+};
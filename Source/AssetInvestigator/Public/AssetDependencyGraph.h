@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetInfo.h"
+#include "AssetData.h"
+
+class FAssetRegistryState;
+
+/**
+ * Package level dependency graph interned into contiguous arrays.
+ * Every package gets a dense node index, hard and soft references are stored as compressed adjacency lists,
+ * so closures can be walked without touching FNames or the asset registry once the graph is built.
+ */
+struct ASSETINVESTIGATOR_API FAssetDependencyGraph
+{
+	/** Memory size of a node that has not been measured (or can not be measured, e.g. cooked content) */
+	static constexpr int64 UnknownSize = -1;
+
+	/**
+	 * Rebuilds the graph from a registry state. Works for the editor's state as well as a state loaded from a cooked build.
+	 *
+	 * @param RegistryState         The registry state to read packages and dependencies from.
+	 * @param PackageSizeOverrides  Optional per package disk sizes that replace the registry's DiskSize (e.g. from a pak listing).
+	 */
+	void Build(const FAssetRegistryState& RegistryState, const TMap<FName, int64>* PackageSizeOverrides = nullptr);
+
+	void Reset();
+
+	int32 Num() const { return PackageNames.Num(); }
+
+	/** @return The node index of the package, or INDEX_NONE if it is not part of the graph */
+	int32 FindNode(const FName PackageName) const;
+
+	FName GetPackageName(const int32 NodeIndex) const { return PackageNames[NodeIndex]; }
+
+	int64 GetDiskSize(const int32 NodeIndex) const { return DiskSizes[NodeIndex]; }
+
+	/**
+	 * Packages that were missing from the PackageSizeOverrides given to Build and kept the registry's uncompressed DiskSize.
+	 * Closures containing them mix compressed and uncompressed sizes, so their disk sizes are approximate.
+	 */
+	int32 GetNumDiskSizeFallbacks() const { return NumDiskSizeFallbacks; }
+
+	int64 GetMemorySize(const int32 NodeIndex) const { return MemorySizes[NodeIndex]; }
+
+	void SetMemorySize(const int32 NodeIndex, const int64 MemorySize) { MemorySizes[NodeIndex] = MemorySize; }
+
+	TArrayView<const int32> GetHardDependencies(const int32 NodeIndex) const;
+
+	TArrayView<const int32> GetSoftDependencies(const int32 NodeIndex) const;
+
+	/**
+	 * Walks hard references starting from RootNode breadth first without recursion, so deep chains can not overflow.
+	 *
+	 * @param RootNode  The node to start from.
+	 * @param OutNodes  Receives every node in the closure, RootNode first.
+	 */
+	void GatherHardClosure(const int32 RootNode, TArray<int32>& OutNodes) const;
+
+	/**
+	 * Allocation free variant for callers that own the scratch memory, e.g. in a linear arena.
+	 *
+	 * @param RootNode     The node to start from.
+	 * @param NodeBuffer   Must hold Num() entries, receives the closure, RootNode first.
+	 * @param VisitedBits  Must hold (Num() + 31) / 32 zeroed words, they are zeroed again on return so the buffer can be reused.
+	 * @return             The number of nodes written to NodeBuffer.
+	 */
+	int32 GatherHardClosure(const int32 RootNode, TArrayView<int32> NodeBuffer, TArrayView<uint32> VisitedBits) const;
+
+	/**
+	 * Sums the sizes of the given nodes. Nodes with an unknown memory size only contribute their disk size and clear bHasKnownMemorySize.
+	 */
+	FAssetSizeInfo SumSizes(TArrayView<const int32> Nodes) const;
+
+private:
+
+	TArray<FName> PackageNames;
+	TMap<FName, int32> NodeIndices;
+
+	TArray<int64> DiskSizes;
+	TArray<int64> MemorySizes;
+
+	int32 NumDiskSizeFallbacks = 0;
+
+	/** Dependencies of node N are Edges[Offsets[N] .. Offsets[N + 1]) */
+	TArray<int32> HardOffsets;
+	TArray<int32> HardEdges;
+	TArray<int32> SoftOffsets;
+	TArray<int32> SoftEdges;
+
+	/** Kept between builds so rebuilding an unchanged registry does not reallocate it */
+	TArray<FAssetIdentifier> DependencyScratch;
+};
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/SecureHash.h"
+
+/**
+ * Packages whose payload is byte for byte identical, e.g. the same texture imported under two paths.
+ */
+struct ASSETINVESTIGATOR_API FAssetDuplicateGroup
+{
+	FName ClassName;
+	TArray<FName> PackageNames;
+
+	/** On disk size of the largest copy, header included */
+	int64 PackageSize = 0;
+
+	/** Size of the identical bulk payload of one copy */
+	int64 PayloadSize = 0;
+
+	/** What the payload of every copy but the first costs */
+	int64 WastedSize = 0;
+};
+
+/**
+ * Finds duplicate content by hashing package payloads: the bulk data section of a package and its .ubulk,
+ * so the package's own name and path do not matter. Packages without bulk data are skipped, their exports
+ * refer to the package's own name table whose indices differ between otherwise identical copies.
+ * Only assets of heavy content classes whose payload size matches another asset of the same class are hashed.
+ * Reads are streamed and spread over a bounded number of workers, and results are cached by file timestamp
+ * and size in Saved/AssetInvestigator, so unchanged files are never read twice.
+ */
+class ASSETINVESTIGATOR_API FAssetDuplicateFinder
+{
+public:
+
+	/**
+	 * Scans the /Game assets of the candidate classes.
+	 *
+	 * @param OutGroups Receives every group of two or more identical packages, most wasted bytes first.
+	 */
+	void FindDuplicates(TArray<FAssetDuplicateGroup>& OutGroups);
+
+	/** Assets the last scan skipped because their package has no bulk data to compare */
+	int32 GetNumSkippedWithoutBulkData() const { return NumSkippedWithoutBulkData; }
+
+private:
+
+	struct FCacheEntry
+	{
+		FDateTime TimeStamp;
+		int64 FileSize = 0;
+
+		int64 PayloadOffset = 0;
+		int64 PayloadSize = 0;
+
+		/** False if neither the package nor a .ubulk holds bulk data, such packages are never hashed */
+		bool bHasBulkData = false;
+
+		FSHAHash Hash;
+		bool bHasHash = false;
+
+		friend FArchive& operator<<(FArchive& Ar, FCacheEntry& Entry)
+		{
+			return Ar << Entry.TimeStamp << Entry.FileSize << Entry.PayloadOffset << Entry.PayloadSize << Entry.bHasBulkData << Entry.Hash << Entry.bHasHash;
+		}
+	};
+
+	struct FCandidate
+	{
+		FName PackageName;
+		FName ClassName;
+		FString Filename;
+		FCacheEntry Entry;
+	};
+
+	/** Reads the package summary to find where the payload starts, false if the file is not a package */
+	static bool ReadPayloadRange(const FString& Filename, FCacheEntry& Entry);
+
+	/** Streams the payload (and a .ubulk next to the package) through SHA1 */
+	static void HashPayload(const FString& Filename, FCacheEntry& Entry);
+
+	/** Runs Work for every index on at most MaxConcurrentReads workers */
+	static void ParallelForBounded(const int32 Num, TFunctionRef<void(int32)> Work);
+
+	static FString GetCachePath();
+
+	void LoadCache();
+	void SaveCache() const;
+
+	/** Enough reads in flight to keep an SSD busy without thrashing a spinning disk */
+	static constexpr int32 MaxConcurrentReads = 8;
+
+	static constexpr int32 ReadChunkSize = 1024 * 1024;
+
+	static constexpr int32 CacheVersion = 2;
+
+	TMap<FString, FCacheEntry> HashCache;
+	bool bHasLoadedCache = false;
+
+	int32 NumSkippedWithoutBulkData = 0;
+};
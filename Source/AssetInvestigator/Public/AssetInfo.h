@@ -12,15 +12,75 @@ struct ASSETINVESTIGATOR_API FAssetSizeInfo
 {
 	int64 MemorySize = 0;
 	int64 DiskSize = 0;
+
+	/** False if some package in the closure could not be measured, e.g. when reading cooked content */
+	bool bHasKnownMemorySize = true;
 };
 
-struct ASSETINVESTIGATOR_API FAssetInfo
+/**
+ * Collection results stored as structure-of-arrays, one row per collected asset.
+ * Object paths live null terminated in a single character arena, packages and references are FAssetDependencyGraph node ids.
+ * Reset keeps every allocation, so collecting again does not touch the heap once the arrays have grown,
+ * and sorting only permutes the row order instead of moving rows around.
+ */
+struct ASSETINVESTIGATOR_API FAssetInfoTable
 {
-	FName AssetPath;
-	FName PackagePath;
-	FAssetSizeInfo AssetSizeInfo;
+	/** Drops all rows but keeps the memory for the next collect */
+	void Reset();
+
+	/** Drops all rows and frees the memory */
+	void Empty();
+
+	int32 Num() const { return PackageNodes.Num(); }
+
+	/**
+	 * Appends a row.
+	 *
+	 * @param AssetPath       The object path of the asset.
+	 * @param PackageNode     The graph node of the asset's package.
+	 * @param AssetSizeInfo   The sizes of the asset's closure.
+	 * @param HardReferences  The package's direct hard references as graph nodes.
+	 * @return                The index of the new row.
+	 */
+	int32 Add(const FName& AssetPath, const int32 PackageNode, const FAssetSizeInfo& AssetSizeInfo, TArrayView<const int32> HardReferences);
+
+	const TCHAR* GetAssetPath(const int32 Row) const { return PathArena.GetData() + PathOffsets[Row]; }
+
+	int32 GetPackageNode(const int32 Row) const { return PackageNodes[Row]; }
+
+	FAssetSizeInfo GetSizeInfo(const int32 Row) const;
+
+	TArrayView<const int32> GetHardReferences(const int32 Row) const;
+
+	/** Bulk payload size of the duplicate copies in the row's closure, 0 until duplicates were searched for */
+	int64 GetDuplicateSize(const int32 Row) const { return DuplicateSizes[Row]; }
+
+	void SetDuplicateSize(const int32 Row, const int64 DuplicateSize) { DuplicateSizes[Row] = DuplicateSize; }
+
+	/** Orders rows by descending memory size, without moving them */
+	void SortByMemorySize();
+
+	/** Orders rows by descending disk size, without moving them */
+	void SortByDiskSize();
+
+	/** @return The row shown at the given position of the sorted list */
+	int32 GetSortedRow(const int32 Position) const { return SortedRows[Position]; }
+
+private:
+
+	TArray<TCHAR> PathArena;
+	TArray<int32> PathOffsets;
+
+	TArray<int32> PackageNodes;
+	TArray<int64> MemorySizes;
+	TArray<int64> DiskSizes;
+	TArray<bool> KnownMemorySizes;
+	TArray<int64> DuplicateSizes;
+
+	/** Hard references of row R are References[ReferenceStarts[R] .. ReferenceStarts[R] + ReferenceCounts[R]) */
+	TArray<int32> ReferenceStarts;
+	TArray<int32> ReferenceCounts;
+	TArray<int32> References;
 
-	TArray<FName> HardReferences;
-	TArray<FName> SoftReferences;
-	TArray<FName> HardCastToNodes;
+	TArray<int32> SortedRows;
 };
@@ -6,10 +6,15 @@
 #include "Modules/ModuleManager.h"
 #include "ImGuiDelegates.h"
 #include "Misc/AssetRegistryInterface.h"
+#include "AssetInfo.h"
+#include "AssetDependencyGraph.h"
+#include "AssetDependencyAnalysis.h"
+#include "CookedAssetRegistry.h"
+#include "LiveMemoryTracker.h"
+#include "AssetClosureTreemap.h"
+#include "AssetDuplicateFinder.h"
 
 struct FAssetData;
-struct FAssetInfo;
-struct FAssetSizeInfo;
 struct FAssetManagerEditorRegistrySource;
 class FToolBarBuilder;
 class FMenuBuilder;
@@ -52,7 +57,7 @@ private:
 	int node_clicked = -1;
 	bool animateProgressBar = false;
 
-	TArray<FAssetInfo> CachedAssets;
+	FAssetInfoTable CachedAssets;
 	TSharedPtr<class FUICommandList> PluginCommands;
 
 	/** The registry source to display information for */
@@ -60,18 +65,84 @@ private:
 
 	TArray<UEdGraphNode*> FoundNodes;
 
+	/** Interned package graph of the registry the current CachedAssets were collected from */
+	FAssetDependencyGraph DependencyGraph;
+
+	/** Development registry of a cook, used instead of the editor registry when bUseCookedRegistry is set */
+	FCookedAssetRegistry CookedRegistry;
+
+	/**
+	 * Per-collect scratch, reset but never freed so a collect over an unchanged project does not touch the heap.
+	 * ClosureBuffer and VisitedBits are the buffers FAssetDependencyGraph::GatherHardClosure expects, VisitedBits is all zero between roots.
+	 */
+	TArray<int32> ClosureBuffer;
+	TArray<uint32> VisitedBits;
+	TArray<FAssetData> FoundAssets;
+	TArray<const FAssetData*> RootAssets;
+	TArray<FAssetData> PackageAssets;
+
+	/**
+	 * Set when the editor registry reports a change, or Clear asks for fresh sizes. Until then collects reuse DependencyGraph
+	 * and the memory sizes measured in it instead of rebuilding and measuring every package again.
+	 */
+	bool bIsDependencyGraphStale = true;
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+
+	bool bUseCookedRegistry = false;
+	bool bCachedAssetsAreCooked = false;
+
+	char CookedPlatformName[64] = "WindowsNoEditor";
+	char PackageListingPath[512] = "";
+
+	/** Root node HeavyDependencies was gathered for, reset whenever DependencyGraph is rebuilt */
+	int32 ExplainedRootNode = INDEX_NONE;
+	int32 ExplainedTargetNode = INDEX_NONE;
+
+	/** Hard closure of ExplainedRootNode without the root, largest packages first */
+	TArray<int32> HeavyDependencies;
+	FAssetDependencyExplanation Explanation;
+
+	/** Samples resident UObjects while the editor or PIE runs, compared against CachedAssets after every sweep */
+	FLiveMemoryTracker LiveMemoryTracker;
+	bool bTrackLiveMemory = false;
+
+	/** Cached treemap layouts of selected roots' closures */
+	FAssetClosureTreemap ClosureTreemap;
+
+	/** Hard reference cycles of DependencyGraph, ordered by CycleSortMode (memory, disk, package count) */
+	TArray<FAssetDependencyCycle> HardCycles;
+	int32 CycleSortMode = 0;
+
+	/** True if some cycle has unmeasured packages, memory sorting then falls back to disk */
+	bool bHasUnknownCycleMemory = false;
+
+	/** The cycle CycleCastToNodes were gathered for */
+	int32 CastToCycleIndex = INDEX_NONE;
+	TArray<UEdGraphNode*> CycleCastToNodes;
+
+	/** Content hashed duplicates under /Game, most wasted bytes first */
+	FAssetDuplicateFinder DuplicateFinder;
+	TArray<FAssetDuplicateGroup> DuplicateGroups;
+
+	/** /Game packages no map, primary asset or always cook directory reaches, largest on disk first */
+	TArray<int32> UnreferencedPackages;
+	int64 UnreferencedDiskSize = 0;
+
 	/*
 	 * Initializes the User Interface for the Asset Investigator, including buttons and progress bar.
 	 */
 	void InitializeUI(bool* p_open = NULL);
 
 	/*
-	 * Gathers information about assets in the project, populating the CachedAssets array.
+	 * Gathers information about assets in the project, populating the CachedAssets table.
 	 */
 	void CollectAssets();
 
 	/**
-	 * Clears the CachedAssets array, resetting any gathered asset information.
+	 * Clears the CachedAssets table, resetting any gathered asset information.
 	 */
 	void ClearAssets();
 
@@ -81,17 +152,75 @@ private:
 	void CreateUtilityButtons();
 
 	/**
-	 * Recursively gathers size information for the specified asset and its dependencies, populating the provided AssetSizeInfo structure.
+	 * Rebuilds DependencyGraph from the cooked registry if one is in use, otherwise from the editor registry.
 	 */
-	void GatherSizeRecursively(const FAssetData& AssetData, FAssetSizeInfo& AssetSizeInfo, TArray<FName>& VisitedAssets);
+	void BuildDependencyGraph();
+
+	/** True if DependencyGraph is missing, out of date or built from the other registry than the one in use */
+	bool IsDependencyGraphStale() const;
+
+	/**
+	 * Creates the inputs for loading a cooked development registry and an optional pak/IoStore listing.
+	 */
+	void CreateCookedRegistryControls();
 
 	/**
-	 * Gathers information about the specified asset, including size and dependencies, and adds it to the CachedAssets array.
+	 * Gathers information about the specified asset, including the size of its hard reference closure in DependencyGraph, and adds it to the CachedAssets table.
+	 * ClosureBuffer and VisitedBits are the scratch buffers FAssetDependencyGraph::GatherHardClosure expects.
 	 */
-	void GatherAssetInformation(const FAssetData& AssetData);
+	void GatherAssetInformation(const FAssetData& AssetData, TArrayView<int32> ClosureBuffer, TArrayView<uint32> VisitedBits);
 
 
 	void DisplayReferences(intptr_t nodeId, const FString& categoryName, UE::AssetRegistry::EDependencyQuery dependencyQuery);
 
-	void DisplayCastToNodes();
+	void DisplayCastToNodes(const TArray<UEdGraphNode*>& CastToNodes);
+
+	/**
+	 * Lists the heaviest packages in the selected root's closure. Picking one shows the hard reference chain that pulls it in
+	 * and the minimal set of references to break, with the memory each break saves.
+	 */
+	void DisplayDependencyExplanation();
+
+	/** Gathers and ranks HeavyDependencies when the explained root changes */
+	void UpdateExplainedRoot(const int32 RootNode);
+
+	/**
+	 * Draws the selected root's closure as a treemap clustered by folder, laid out on a worker thread.
+	 */
+	void DisplayClosureTreemap();
+
+	/**
+	 * Shows resident versus predicted memory of the loaded roots and the resident packages no loaded root needs.
+	 */
+	void DisplayLiveMemory();
+
+	/**
+	 * Finds every hard reference cycle in DependencyGraph, building the graph first if nothing was collected yet.
+	 */
+	void FindHardCycles();
+
+	void SortHardCycles();
+
+	/**
+	 * Lists the hard reference cycles with their combined size, edges and the <CastTo> nodes that form them.
+	 */
+	void DisplayHardCycles();
+
+	/**
+	 * Hashes the payloads of heavy /Game assets and lists the groups of identical ones.
+	 */
+	void DisplayDuplicateAssets();
+
+	/**
+	 * Finds the /Game packages nothing the cook keeps reaches over hard or soft references, building the graph first if nothing was collected yet.
+	 */
+	void FindUnreferencedPackages();
+
+	void DisplayUnreferencedPackages();
+
+	/** Stores in every CachedAssets row the payload size of the duplicate copies its closure pulls in */
+	void UpdateDuplicateSizes();
+
+	/** The size CachedAssets are ranked by: memory for the editor registry, disk for a cooked one */
+	int64 GetRankingSize(const int32 NodeIndex) const;
 };
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AssetInvestigatorCommandlet.generated.h"
+
+/**
+ * Headless cooked-content analysis. Loads a development asset registry (and optionally a pak/IoStore listing)
+ * from a cook output folder and writes the closure sizes of every Blueprint, the same report the editor window exports.
+ *
+ * UE4Editor-Cmd <Project> -run=AssetInvestigator -Platform=LinuxNoEditor [-Registry=<path>] [-PakList=<path>] [-Report=<path>]
+ *
+ * With -Exact it loads and measures the memory of every package the Blueprints' closures reach instead, optionally split
+ * into several package lists that are measured by separate editor processes and merged into one report:
+ *
+ * UE4Editor-Cmd <Project> -run=AssetInvestigator -Exact [-Shards=<count>] [-MaxParallelShards=<count>] [-MaxMemoryMB=<cap per process>] [-Report=<path>]
+ */
+UCLASS()
+class UAssetInvestigatorCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UAssetInvestigatorCommandlet();
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+
+private:
+
+	/** Exact memory measurement, as the driver of -Shards=N, as one of its shards (-ShardInput=) or all in this process */
+	int32 RunExactCollection(const FString& Params);
+};
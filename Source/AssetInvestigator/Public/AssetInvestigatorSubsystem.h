@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EditorSubsystem.h"
+#include "AssetData.h"
+#include "AssetDependencyGraph.h"
+#include "AssetInvestigatorSubsystem.generated.h"
+
+/**
+ * Sizes of a package's hard reference closure, or of the part of it only that package pulls in.
+ */
+USTRUCT(BlueprintType)
+struct ASSETINVESTIGATOR_API FAssetInvestigatorSizeResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "AssetInvestigator")
+	FName PackageName;
+
+	/** False if the package is not in the graph, every other field is then zero */
+	UPROPERTY(BlueprintReadOnly, Category = "AssetInvestigator")
+	bool bFound = false;
+
+	/** Packages in the closure, left at zero by GetExclusiveSizes */
+	UPROPERTY(BlueprintReadOnly, Category = "AssetInvestigator")
+	int32 NumPackages = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "AssetInvestigator")
+	int64 DiskSize = 0;
+
+	/** Sum of the packages measured so far, see bHasKnownMemorySize */
+	UPROPERTY(BlueprintReadOnly, Category = "AssetInvestigator")
+	int64 MemorySize = 0;
+
+	/** False if some package was never measured, i.e. the query did not ask to measure memory and no earlier one did since the graph was rebuilt */
+	UPROPERTY(BlueprintReadOnly, Category = "AssetInvestigator")
+	bool bHasKnownMemorySize = false;
+};
+
+/**
+ * The packages nothing hard references that pull a package in.
+ */
+USTRUCT(BlueprintType)
+struct ASSETINVESTIGATOR_API FAssetInvestigatorRootsResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "AssetInvestigator")
+	FName PackageName;
+
+	UPROPERTY(BlueprintReadOnly, Category = "AssetInvestigator")
+	TArray<FName> Roots;
+};
+
+/**
+ * The shortest hard reference chain from one package to another.
+ */
+USTRUCT(BlueprintType)
+struct ASSETINVESTIGATOR_API FAssetInvestigatorPathResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "AssetInvestigator")
+	FName From;
+
+	UPROPERTY(BlueprintReadOnly, Category = "AssetInvestigator")
+	FName To;
+
+	/** From first and To last, empty if To is not in From's hard closure */
+	UPROPERTY(BlueprintReadOnly, Category = "AssetInvestigator")
+	TArray<FName> Path;
+};
+
+/**
+ * Batch queries over the dependency graph of the editor asset registry for editor Python and Blueprint.
+ * Every query takes the whole batch at once and answers it natively against a cached graph,
+ * so a script pays for one call instead of one walk per asset. Assets can be given as package names or object paths.
+ *
+ * The subsystem owns its graph, independent of the registry source the Asset Investigator window shows. Registry events
+ * mark it stale and the next query rebuilds it. Size queries given bMeasureMemory load and measure the packages of the closures
+ * that are still unknown, the sizes are kept in the graph until it is rebuilt so later queries reuse them.
+ *
+ *     subsystem = unreal.get_editor_subsystem(unreal.AssetInvestigatorSubsystem)
+ *     results = subsystem.get_closure_sizes(["/Game/Maps/Main", "/Game/UI/HUD"])
+ */
+UCLASS()
+class ASSETINVESTIGATOR_API UAssetInvestigatorSubsystem : public UEditorSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	/** Rebuilds the graph on the next query, e.g. after changes the registry does not report such as edited dependencies of unsaved packages */
+	UFUNCTION(BlueprintCallable, Category = "AssetInvestigator")
+	void RefreshGraph();
+
+	/**
+	 * Sizes of each asset's whole hard reference closure, the asset included.
+	 *
+	 * @param bMeasureMemory  Loads the closures' packages whose memory is still unknown to measure them, otherwise their memory stays unknown.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "AssetInvestigator")
+	TArray<FAssetInvestigatorSizeResult> GetClosureSizes(const TArray<FName>& Assets, bool bMeasureMemory = false);
+
+	/**
+	 * Sizes of the part of each asset's hard closure no other asset of the batch reaches,
+	 * i.e. what would no longer be loaded if only that asset went away.
+	 *
+	 * @param bMeasureMemory  Loads the closures' packages whose memory is still unknown to measure them, otherwise their memory stays unknown.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "AssetInvestigator")
+	TArray<FAssetInvestigatorSizeResult> GetExclusiveSizes(const TArray<FName>& Assets, bool bMeasureMemory = false);
+
+	/** The packages nothing outside their own cycle hard references, such as maps and primary assets, that pull each asset in */
+	UFUNCTION(BlueprintCallable, Category = "AssetInvestigator")
+	TArray<FAssetInvestigatorRootsResult> GetReverseRoots(const TArray<FName>& Assets);
+
+	/** The shortest hard reference chain for each pair From[i] -> To[i], both arrays must have the same length */
+	UFUNCTION(BlueprintCallable, Category = "AssetInvestigator")
+	TArray<FAssetInvestigatorPathResult> FindPathsBetween(const TArray<FName>& From, const TArray<FName>& To);
+
+	/**
+	 * The assets whose hard closure exceeds a budget, largest first. Closures whose memory was not measured are kept
+	 * when a memory budget is given, with bHasKnownMemorySize false, and ranked after the measured ones.
+	 *
+	 * @param Assets         The assets to check.
+	 * @param MaxDiskSize    Disk budget in bytes, 0 or less for no disk limit.
+	 * @param MaxMemorySize  Memory budget in bytes, 0 or less for no memory limit. With neither limit every found asset is returned.
+	 * @param bMeasureMemory  Loads the closures' packages whose memory is still unknown to measure them, otherwise their memory stays unknown.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "AssetInvestigator")
+	TArray<FAssetInvestigatorSizeResult> FilterOverBudget(const TArray<FName>& Assets, int64 MaxDiskSize, int64 MaxMemorySize, bool bMeasureMemory = false);
+
+private:
+
+	/** The graph, rebuilt from the editor registry if it is stale, with the memory sizes measured since */
+	const FAssetDependencyGraph& GetGraph();
+
+	/**
+	 * Measures the packages of the nodes' hard closures whose memory is still unknown.
+	 * ClosureBuffer and VisitedBits are the scratch buffers FAssetDependencyGraph::GatherHardClosure expects.
+	 */
+	void MeasureClosures(TArrayView<const int32> Nodes, TArrayView<int32> ClosureBuffer, TArrayView<uint32> VisitedBits);
+
+	void OnAssetChanged(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+	FAssetDependencyGraph RegistryGraph;
+	bool bIsGraphStale = true;
+
+	/** Receives each measured package's assets, kept so measuring many packages reuses one allocation */
+	TArray<FAssetData> PackageAssets;
+
+	/** Looks up package names and object paths, INDEX_NONE for assets the graph does not know */
+	static void ResolveNodes(const FAssetDependencyGraph& Graph, const TArray<FName>& Assets, TArray<int32>& OutNodes);
+};
@@ -2,7 +2,10 @@
 
 #include "CoreMinimal.h"
 
-struct FAssetInfo;
+struct FAssetInfoTable;
+struct FAssetDependencyGraph;
+struct FAssetDependencyCycle;
+struct FAssetDuplicateGroup;
 
 /**
  * Utility class for asset investigation in Unreal Engine 4.
@@ -28,9 +31,27 @@ public:
 	/**
 	 * Exports a list of asset information to a text file.
 	 *
-	 * @param AssetInfoList The list of asset information to export.
+	 * @param AssetInfoList The table of asset information to export, written in its sorted order.
+	 * @param FilePath      Where to write the report, defaults to AssetInvestigatorReport.txt in ProjectDir().
+	 * @param DuplicateGroups If given and not empty, every row also reports its duplicate waste and the groups are listed at the end.
 	 */
-	static void ExportListToTxt(const TArray<FAssetInfo>& AssetInfoList);
+	static void ExportListToTxt(const FAssetInfoTable& AssetInfoList, const FString& FilePath = FString(), const TArray<FAssetDuplicateGroup>* DuplicateGroups = nullptr);
+
+	/**
+	 * Builds a graph from what the editor asset registry currently knows, with dependencies and package data, reading its live state without copying it.
+	 *
+	 * @param OutGraph The graph to rebuild, its memory sizes start unknown.
+	 */
+	static void BuildEditorDependencyGraph(FAssetDependencyGraph& OutGraph);
+
+	/**
+	 * Measures the memory of every asset in the package, loading them if needed.
+	 *
+	 * @param PackageName    The package to measure.
+	 * @param ScratchAssets  Receives the package's assets, kept by the caller so measuring many packages reuses one allocation.
+	 * @return               The estimated total resource size of the package's assets.
+	 */
+	static int64 GetPackageMemorySize(const FName& PackageName, TArray<FAssetData>& ScratchAssets);
 
 	/**
 	 * Creates a formatted string representation of a size value.
@@ -42,4 +63,43 @@ public:
 	static FString MakeBestSizeString(const SIZE_T SizeInBytes, const bool bHasKnownSize);
 
 	static TArray<UEdGraphNode*> GetDynamicCastToNodes(const FName& AssetPath);
-};
\ No newline at end of file
+
+	/**
+	 * Finds the <CastTo> nodes in the Blueprints of the given packages that cast to a class of another of these packages,
+	 * i.e. the nodes that create the hard references of a reference cycle.
+	 *
+	 * @param PackageNames The packages of the cycle.
+	 * @return             The cast nodes, loading the Blueprints if needed.
+	 */
+	static TArray<UEdGraphNode*> GetCyclicCastToNodes(const TArray<FName>& PackageNames);
+
+	/**
+	 * Exports hard reference cycles to a text file, one block per cycle with its packages, edges and the <CastTo> nodes
+	 * closing it. Finding those nodes loads the cycles' Blueprints behind a cancellable progress dialog, cancelling still writes
+	 * every cycle but lists the nodes only for the cycles done so far.
+	 *
+	 * @param Cycles   The cycles to export, in the order given.
+	 * @param Graph    The graph the cycles were found in.
+	 * @param FilePath Where to write the report, defaults to AssetInvestigatorCycles.txt in ProjectDir().
+	 */
+	static void ExportCyclesToTxt(const TArray<FAssetDependencyCycle>& Cycles, const FAssetDependencyGraph& Graph, const FString& FilePath = FString());
+
+	/**
+	 * Gathers the packages a cook keeps regardless of references: the maps to cook (every /Game map if none are listed),
+	 * the default map, game mode and game instance, the Asset Manager's primary assets ruled AlwaysCook or DevelopmentAlwaysCook
+	 * and everything in the always cook directories.
+	 *
+	 * @param Graph     The graph to look the packages up in.
+	 * @param OutRoots  Receives the graph nodes of the root packages.
+	 */
+	static void GatherCookRoots(const FAssetDependencyGraph& Graph, TArray<int32>& OutRoots);
+
+	/**
+	 * Exports packages nothing references to a text file, one package per line with its disk size.
+	 *
+	 * @param Nodes    The unreferenced packages, in the order given.
+	 * @param Graph    The graph the packages were found in.
+	 * @param FilePath Where to write the report, defaults to AssetInvestigatorUnreferenced.txt in ProjectDir().
+	 */
+	static void ExportUnreferencedToTxt(const TArray<int32>& Nodes, const FAssetDependencyGraph& Graph, const FString& FilePath = FString());
+};
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FAssetData;
+class FAssetRegistryState;
+
+/**
+ * Holds a development AssetRegistry.bin produced by the cooker, loaded straight from disk next to the live registry.
+ * Optionally merges a pak (UnrealPak -List) or IoStore (-List CSV) listing so closures use the shipped, compressed sizes.
+ */
+class ASSETINVESTIGATOR_API FCookedAssetRegistry
+{
+public:
+
+	FCookedAssetRegistry();
+	~FCookedAssetRegistry();
+
+	/**
+	 * @param PlatformName The cooked platform folder, e.g. WindowsNoEditor or LinuxNoEditor.
+	 * @return             Path of the development registry the cooker writes for that platform.
+	 */
+	static FString GetDevelopmentRegistryPath(const FString& PlatformName);
+
+	/**
+	 * Streams a development registry from disk through a buffered file reader (not a memory map). Any previously loaded registry and listing are dropped.
+	 *
+	 * @param RegistryPath The path of DevelopmentAssetRegistry.bin.
+	 * @return             True if the registry was loaded.
+	 */
+	bool LoadDevelopmentRegistry(const FString& RegistryPath);
+
+	/**
+	 * Reads a pak or IoStore listing and records the on-disk size of each package, summed over .uasset/.uexp/.ubulk.
+	 *
+	 * @param ListingPath The path of the text or CSV listing.
+	 * @return            True if at least one package size was read.
+	 */
+	bool LoadPackageListing(const FString& ListingPath);
+
+	/**
+	 * Collects the Blueprint assets under /Game, the same roots CollectAssets uses for the editor registry.
+	 */
+	void GatherRootAssets(TArray<const FAssetData*>& OutAssets) const;
+
+	bool IsLoaded() const { return bIsLoaded; }
+
+	const FAssetRegistryState& GetState() const { return *State; }
+
+	/** Per package sizes from the listing, empty if no listing was loaded */
+	const TMap<FName, int64>& GetPackageSizes() const { return ListedPackageSizes; }
+
+	/**
+	 * Converts a cooked file name such as ../../../MyGame/Content/Maps/Entry.umap to /Game/Maps/Entry.
+	 *
+	 * @return False if the file is not a package file below a Content folder.
+	 */
+	static bool TryConvertCookedFilenameToPackageName(const FString& CookedFilename, FString& OutPackageName);
+
+private:
+
+	TUniquePtr<FAssetRegistryState> State;
+	TMap<FName, int64> ListedPackageSizes;
+	bool bIsLoaded = false;
+};
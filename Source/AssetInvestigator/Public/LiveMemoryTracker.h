@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+struct FAssetDependencyGraph;
+struct FAssetInfoTable;
+
+/**
+ * Result of comparing a live sweep with the closures CollectAssets predicted.
+ */
+struct ASSETINVESTIGATOR_API FLiveMemoryComparison
+{
+	struct FLoadedRoot
+	{
+		/** Row in the FAssetInfoTable the prediction came from */
+		int32 Row = INDEX_NONE;
+
+		int64 PredictedMemorySize = 0;
+		int64 ResidentMemorySize = 0;
+	};
+
+	struct FUnclaimedPackage
+	{
+		int32 Node = INDEX_NONE;
+		int64 ResidentMemorySize = 0;
+	};
+
+	/** Collected roots whose package is resident, with what their closure uses right now */
+	TArray<FLoadedRoot> LoadedRoots;
+
+	/** Resident packages that no loaded root needs, largest first */
+	TArray<FUnclaimedPackage> UnclaimedPackages;
+
+	int64 UnclaimedMemorySize = 0;
+};
+
+/**
+ * Samples loaded UObjects grouped by their owning package while the editor or a PIE session runs.
+ * A sweep over GUObjectArray is spread over many low frequency ticks with a small per tick time budget,
+ * so tracking never causes a hitch. Sizes are published once a full sweep completes.
+ * Comparisons with the predicted closures run on the same ticks and budget, pausing the sweep until they are done.
+ */
+class ASSETINVESTIGATOR_API FLiveMemoryTracker
+{
+public:
+
+	~FLiveMemoryTracker();
+
+	void Start();
+
+	void Stop();
+
+	bool IsRunning() const { return TickerHandle.IsValid(); }
+
+	/** Increases every time a sweep completes and GetResidentPackageSizes changes */
+	int32 GetCompletedSweeps() const { return CompletedSweeps; }
+
+	/** @return How far the current sweep is, between 0 and 1 */
+	float GetSweepProgress() const;
+
+	/** Resident memory per package from the last completed sweep */
+	const TMap<FName, int64>& GetResidentPackageSizes() const { return ResidentPackageSizes; }
+
+	/**
+	 * Starts comparing the last completed sweep with predicted closure sizes, one root after another over the following ticks.
+	 * Both arguments must stay alive and unchanged until the comparison is published or ResetComparison is called.
+	 *
+	 * @param Graph  The graph the roots were collected from.
+	 * @param Roots  The collected roots and their predicted sizes.
+	 */
+	void StartComparison(const FAssetDependencyGraph& Graph, const FAssetInfoTable& Roots);
+
+	/** Drops the published comparison and stops one in progress, e.g. because the roots were collected again */
+	void ResetComparison();
+
+	bool IsComparing() const { return ComparedGraph != nullptr; }
+
+	/** The sweep the published comparison was made from, INDEX_NONE if there is none */
+	int32 GetComparedSweep() const { return ComparedSweep; }
+
+	/** The loaded roots and the resident packages none of them needs, as of GetComparedSweep */
+	const FLiveMemoryComparison& GetComparison() const { return Comparison; }
+
+private:
+
+	bool Tick(float DeltaTime);
+
+	/** Compares roots until EndTime, publishes the comparison once every root is done */
+	void AdvanceComparison(const double EndTime);
+
+	/** Objects between two budget checks, FPlatformTime::Seconds is not free either */
+	static constexpr int32 ObjectsPerBudgetCheck = 256;
+
+	/** How often the sweep advances and how long each step may take */
+	static constexpr float TickInterval = 0.1f;
+	static constexpr double TickBudgetSeconds = 0.001;
+
+	FDelegateHandle TickerHandle;
+
+	int32 NextObjectIndex = 0;
+	int32 CompletedSweeps = 0;
+
+	TMap<FName, int64> PendingPackageSizes;
+	TMap<FName, int64> ResidentPackageSizes;
+
+	/** Comparison in progress, ComparedGraph is null when none is */
+	const FAssetDependencyGraph* ComparedGraph = nullptr;
+	const FAssetInfoTable* ComparedRoots = nullptr;
+	int32 NextComparedRow = 0;
+	int32 ComparingSweep = INDEX_NONE;
+	FLiveMemoryComparison PendingComparison;
+
+	/**
+	 * Scratch kept between comparisons: resident size per graph node (INDEX_NONE if not resident), mapped from package names
+	 * once per comparison, a bit per node needed by a loaded root, and the buffers FAssetDependencyGraph::GatherHardClosure expects.
+	 */
+	TArray<int64> ResidentNodeSizes;
+	TBitArray<> NeededNodes;
+	TArray<int32> ClosureBuffer;
+	TArray<uint32> VisitedBits;
+
+	FLiveMemoryComparison Comparison;
+	int32 ComparedSweep = INDEX_NONE;
+};